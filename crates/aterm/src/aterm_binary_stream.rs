@@ -510,10 +510,7 @@ impl<R: Read> ATermRead for BinaryATermReader<R> {
             .read_aterm()?
             .ok_or("Missing number of elements for iterator")?
             .into();
-        Ok(ATermReadIter {
-            reader: self,
-            remaining: number_of_elements.value(),
-        })
+        Ok(ATermReadIter::new(self, number_of_elements.value()))
     }
 }
 
@@ -527,13 +524,20 @@ impl<R: Read> BitStreamRead for BinaryATermReader<R> {
     }
 }
 
-/// A read iterator for ATerms from a binary aterm input stream.
-pub struct ATermReadIter<'a, R: Read> {
-    reader: &'a mut BinaryATermReader<R>,
+/// A read iterator for ATerms from an aterm input stream.
+pub struct ATermReadIter<'a, R: ATermRead> {
+    reader: &'a mut R,
     remaining: usize,
 }
 
-impl<'a, R: Read> Iterator for ATermReadIter<'a, R> {
+impl<'a, R: ATermRead> ATermReadIter<'a, R> {
+    /// Creates an iterator that reads the given number of terms from the reader.
+    pub fn new(reader: &'a mut R, remaining: usize) -> Self {
+        Self { reader, remaining }
+    }
+}
+
+impl<'a, R: ATermRead> Iterator for ATermReadIter<'a, R> {
     type Item = Result<ATerm, MercError>;
 
     fn next(&mut self) -> Option<Self::Item> {
@@ -558,7 +562,7 @@ impl<'a, R: Read> Iterator for ATermReadIter<'a, R> {
     }
 }
 
-impl<'a, R: Read> ExactSizeIterator for ATermReadIter<'a, R> {
+impl<'a, R: ATermRead> ExactSizeIterator for ATermReadIter<'a, R> {
     fn len(&self) -> usize {
         self.remaining
     }
@@ -0,0 +1,471 @@
+#![forbid(unsafe_code)]
+
+use std::io::Cursor;
+use std::io::Error;
+use std::io::ErrorKind;
+use std::io::Read;
+use std::io::Write;
+
+use log::warn;
+use merc_utilities::MercError;
+
+use crate::ATerm;
+use crate::ATermInt;
+use crate::ATermRead;
+use crate::ATermReadIter;
+use crate::ATermSend;
+use crate::ATermWrite;
+use crate::BinaryATermReader;
+use crate::BinaryATermWriter;
+use crate::Term;
+
+/// The magic value for a chunked binary aterm format stream, follows the
+/// convention of the BAF_MAGIC value.
+const CAF_MAGIC: u16 = 0x8caf;
+
+/// The version of the chunked binary aterm format.
+const CAF_VERSION: u16 = 0x0001;
+
+/// The default number of terms per chunk.
+const DEFAULT_CHUNK_SIZE: usize = 65536;
+
+/// Writes terms in a chunked binary aterm format to an output stream.
+///
+/// # The chunked aterm format:
+///
+/// The stream starts with a zero byte followed by a magic and a version. After
+/// the header follows a sequence of frames, where every frame consists of the
+/// byte length and the number of terms of the chunk (both 64-bit little
+/// endian) followed by the chunk itself. Every chunk is a self-contained
+/// stream in the format of [`BinaryATermWriter`] with its own local symbol and
+/// term dictionaries. There is no end-of-stream marker; the stream ends at the
+/// end of the underlying file.
+///
+/// Compared to the flat format this loses the sharing between terms in
+/// different chunks, but in return the chunks can be compressed on multiple
+/// threads, new frames can be appended to an existing stream without reading
+/// it back, a reader can skip to any chunk using only the frame lengths, and
+/// all complete frames of a partially written stream remain readable.
+pub struct ChunkedATermWriter<W: Write> {
+    writer: W,
+    threads: usize,
+    chunk_size: usize,
+
+    /// The terms of the chunk that is currently being filled.
+    buffer: Vec<ATermSend>,
+
+    /// Completed chunks waiting to be compressed in parallel.
+    pending: Vec<Vec<ATermSend>>,
+
+    /// Indicates whether the stream has been flushed.
+    flushed: bool,
+}
+
+impl<W: Write> ChunkedATermWriter<W> {
+    /// Creates a new chunked aterm output stream with the given writer, using
+    /// the given number of threads to compress chunks.
+    pub fn new(writer: W, threads: usize) -> Result<Self, MercError> {
+        Self::with_chunk_size(writer, threads, DEFAULT_CHUNK_SIZE)
+    }
+
+    /// Creates a new chunked aterm output stream with the given number of terms per chunk.
+    pub fn with_chunk_size(mut writer: W, threads: usize, chunk_size: usize) -> Result<Self, MercError> {
+        // Write the header of the chunked aterm format.
+        writer.write_all(&[0u8])?;
+        writer.write_all(&CAF_MAGIC.to_le_bytes())?;
+        writer.write_all(&CAF_VERSION.to_le_bytes())?;
+
+        Ok(Self::append_with_chunk_size(writer, threads, chunk_size))
+    }
+
+    /// Creates a writer that appends frames to an existing chunked aterm
+    /// stream, without writing a header. The underlying writer must be
+    /// positioned at the end of a stream written by [`ChunkedATermWriter`].
+    pub fn append(writer: W, threads: usize) -> Self {
+        Self::append_with_chunk_size(writer, threads, DEFAULT_CHUNK_SIZE)
+    }
+
+    /// See [`ChunkedATermWriter::append`], with the given number of terms per chunk.
+    pub fn append_with_chunk_size(writer: W, threads: usize, chunk_size: usize) -> Self {
+        debug_assert!(chunk_size > 0, "Chunks must contain at least one term");
+
+        Self {
+            writer,
+            threads: threads.max(1),
+            chunk_size,
+            buffer: Vec::new(),
+            pending: Vec::new(),
+            flushed: false,
+        }
+    }
+
+    /// Compresses all pending chunks, in parallel when more than one chunk is
+    /// waiting, and writes their frames to the underlying writer in order.
+    fn write_pending(&mut self) -> Result<(), MercError> {
+        if self.pending.is_empty() {
+            return Ok(());
+        }
+
+        let chunks = std::mem::take(&mut self.pending);
+        let encoded: Vec<Result<(Vec<u8>, usize), MercError>> = if chunks.len() <= 1 {
+            chunks.into_iter().map(encode_chunk).collect()
+        } else {
+            std::thread::scope(|scope| {
+                let handles: Vec<_> = chunks
+                    .into_iter()
+                    .map(|chunk| scope.spawn(move || encode_chunk(chunk)))
+                    .collect();
+
+                handles
+                    .into_iter()
+                    .map(|handle| handle.join().expect("The compression thread should not panic"))
+                    .collect()
+            })
+        };
+
+        for result in encoded {
+            let (bytes, number_of_terms) = result?;
+            self.writer.write_all(&(bytes.len() as u64).to_le_bytes())?;
+            self.writer.write_all(&(number_of_terms as u64).to_le_bytes())?;
+            self.writer.write_all(&bytes)?;
+        }
+
+        Ok(())
+    }
+}
+
+/// Compresses a single chunk into a self-contained binary aterm stream.
+fn encode_chunk(chunk: Vec<ATermSend>) -> Result<(Vec<u8>, usize), MercError> {
+    let number_of_terms = chunk.len();
+    let mut bytes: Vec<u8> = Vec::new();
+
+    let mut stream = BinaryATermWriter::new(&mut bytes)?;
+    for term in &chunk {
+        stream.write_aterm(&term.protect())?;
+    }
+    ATermWrite::flush(&mut stream)?;
+    drop(stream);
+
+    Ok((bytes, number_of_terms))
+}
+
+impl<W: Write> ATermWrite for ChunkedATermWriter<W> {
+    fn write_aterm(&mut self, term: &ATerm) -> Result<(), MercError> {
+        self.buffer.push(ATermSend::from(term.clone()));
+
+        if self.buffer.len() >= self.chunk_size {
+            self.pending.push(std::mem::take(&mut self.buffer));
+
+            // Wait for enough chunks to keep all compression threads busy.
+            if self.pending.len() >= self.threads {
+                self.write_pending()?;
+            }
+        }
+
+        Ok(())
+    }
+
+    fn write_aterm_iter<I>(&mut self, iter: I) -> Result<(), MercError>
+    where
+        I: ExactSizeIterator<Item = ATerm>,
+    {
+        self.write_aterm(&ATermInt::new(iter.len()))?;
+        for term in iter {
+            self.write_aterm(&term)?;
+        }
+        Ok(())
+    }
+
+    fn flush(&mut self) -> Result<(), MercError> {
+        if !self.buffer.is_empty() {
+            self.pending.push(std::mem::take(&mut self.buffer));
+        }
+
+        self.write_pending()?;
+        self.writer.flush()?;
+        self.flushed = true;
+        Ok(())
+    }
+}
+
+impl<W: Write> Drop for ChunkedATermWriter<W> {
+    fn drop(&mut self) {
+        if !self.flushed {
+            ATermWrite::flush(self).expect("Panicked while flushing the stream when dropped");
+        }
+    }
+}
+
+/// The reader counterpart of [`ChunkedATermWriter`], which reads ATerms from a
+/// chunked binary aterm input stream.
+pub struct ChunkedATermReader<R: Read> {
+    reader: R,
+
+    /// The reader over the current chunk, or None when the next frame has not been read yet.
+    current: Option<BinaryATermReader<Cursor<Vec<u8>>>>,
+
+    /// Indicates whether the end of the underlying stream has been reached.
+    ended: bool,
+}
+
+impl<R: Read> ChunkedATermReader<R> {
+    /// Checks for the header and initializes the chunked aterm input stream.
+    pub fn new(mut reader: R) -> Result<Self, MercError> {
+        let mut header = [0u8; 5];
+        reader.read_exact(&mut header)?;
+
+        if header[0] != 0 || u16::from_le_bytes([header[1], header[2]]) != CAF_MAGIC {
+            return Err(Error::new(ErrorKind::InvalidData, "Missing CAF_MAGIC control sequence").into());
+        }
+
+        let version = u16::from_le_bytes([header[3], header[4]]);
+        if version != CAF_VERSION {
+            return Err(Error::new(
+                ErrorKind::InvalidData,
+                format!("CAF version ({version}) incompatible with expected version ({CAF_VERSION})"),
+            )
+            .into());
+        }
+
+        Ok(Self {
+            reader,
+            current: None,
+            ended: false,
+        })
+    }
+
+    /// Skips ahead to the last complete chunk of the stream using only the
+    /// frame headers, without decoding the skipped chunks. Returns the number
+    /// of terms that were skipped; subsequent reads return the terms of the
+    /// last chunk.
+    pub fn skip_to_last_chunk(&mut self) -> Result<usize, MercError> {
+        let mut skipped = 0;
+        let mut last: Option<(Vec<u8>, usize)> = None;
+
+        while let Some((bytes, number_of_terms)) = self.read_frame()? {
+            if let Some((_, previous_terms)) = last.replace((bytes, number_of_terms)) {
+                skipped += previous_terms;
+            }
+        }
+
+        if let Some((bytes, _)) = last {
+            self.current = Some(BinaryATermReader::new(Cursor::new(bytes))?);
+            self.ended = false;
+        }
+
+        Ok(skipped)
+    }
+
+    /// Reads the next frame from the underlying stream. Returns None at the
+    /// end of the stream; an incomplete trailing frame, as left behind by a
+    /// crashed writer, is also treated as the end of the stream.
+    fn read_frame(&mut self) -> Result<Option<(Vec<u8>, usize)>, MercError> {
+        if self.ended {
+            return Ok(None);
+        }
+
+        let mut header = [0u8; 16];
+        let mut read = 0;
+        while read < header.len() {
+            match self.reader.read(&mut header[read..])? {
+                0 => {
+                    if read != 0 {
+                        warn!("Ignoring incomplete trailing frame header of a chunked aterm stream");
+                    }
+                    self.ended = true;
+                    return Ok(None);
+                }
+                n => read += n,
+            }
+        }
+
+        let length = u64::from_le_bytes(header[0..8].try_into().expect("The slice has the correct length")) as usize;
+        let number_of_terms =
+            u64::from_le_bytes(header[8..16].try_into().expect("The slice has the correct length")) as usize;
+
+        let mut bytes = vec![0u8; length];
+        let mut read = 0;
+        while read < length {
+            match self.reader.read(&mut bytes[read..])? {
+                0 => {
+                    warn!("Ignoring incomplete trailing frame of a chunked aterm stream");
+                    self.ended = true;
+                    return Ok(None);
+                }
+                n => read += n,
+            }
+        }
+
+        Ok(Some((bytes, number_of_terms)))
+    }
+}
+
+impl<R: Read> ATermRead for ChunkedATermReader<R> {
+    fn read_aterm(&mut self) -> Result<Option<ATerm>, MercError> {
+        loop {
+            if let Some(current) = &mut self.current {
+                if let Some(term) = current.read_aterm()? {
+                    return Ok(Some(term));
+                }
+
+                // The end-of-stream marker of the chunk was reached.
+                self.current = None;
+            }
+
+            match self.read_frame()? {
+                Some((bytes, _)) => {
+                    self.current = Some(BinaryATermReader::new(Cursor::new(bytes))?);
+                }
+                None => return Ok(None),
+            }
+        }
+    }
+
+    fn read_aterm_iter(&mut self) -> Result<impl ExactSizeIterator<Item = Result<ATerm, MercError>>, MercError> {
+        let number_of_elements: ATermInt = self
+            .read_aterm()?
+            .ok_or("Missing number of elements for iterator")?
+            .into();
+        Ok(ATermReadIter::new(self, number_of_elements.value()))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use merc_utilities::random_test;
+    use rand::Rng;
+
+    use crate::random_term;
+
+    use super::*;
+
+    /// Returns a vector of random terms for the round trip tests.
+    fn random_terms(rng: &mut impl rand::Rng, amount: usize) -> Vec<ATerm> {
+        (0..amount)
+            .map(|_| random_term(rng, &[("f".into(), 2), ("g".into(), 1)], &["a".into(), "b".into()], 1))
+            .collect()
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Miri is too slow
+    fn test_random_chunked_stream() {
+        random_test(25, |rng| {
+            let input = random_terms(rng, 20);
+            let mut stream: Vec<u8> = Vec::new();
+
+            // A small chunk size such that the stream contains multiple chunks.
+            let mut output_stream = ChunkedATermWriter::with_chunk_size(&mut stream, 2, 3).unwrap();
+            for term in &input {
+                output_stream.write_aterm(term).unwrap();
+            }
+            ATermWrite::flush(&mut output_stream).expect("Flushing the output to the stream");
+            drop(output_stream);
+
+            let mut input_stream = ChunkedATermReader::new(&stream[..]).unwrap();
+            for term in &input {
+                assert_eq!(
+                    *term,
+                    input_stream.read_aterm().unwrap().unwrap(),
+                    "The read term must match the term that we have written"
+                );
+            }
+            assert!(
+                input_stream.read_aterm().unwrap().is_none(),
+                "The stream must end after the written terms"
+            );
+        });
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Miri is too slow
+    fn test_random_chunked_stream_append() {
+        random_test(25, |rng| {
+            let input = random_terms(rng, 10);
+            let appended = random_terms(rng, 10);
+            let mut stream: Vec<u8> = Vec::new();
+
+            let mut output_stream = ChunkedATermWriter::with_chunk_size(&mut stream, 2, 3).unwrap();
+            for term in &input {
+                output_stream.write_aterm(term).unwrap();
+            }
+            ATermWrite::flush(&mut output_stream).expect("Flushing the output to the stream");
+            drop(output_stream);
+
+            // Appending does not require reading the existing stream back.
+            let mut append_stream = ChunkedATermWriter::append_with_chunk_size(&mut stream, 2, 3);
+            for term in &appended {
+                append_stream.write_aterm(term).unwrap();
+            }
+            ATermWrite::flush(&mut append_stream).expect("Flushing the output to the stream");
+            drop(append_stream);
+
+            let mut input_stream = ChunkedATermReader::new(&stream[..]).unwrap();
+            for term in input.iter().chain(&appended) {
+                assert_eq!(
+                    *term,
+                    input_stream.read_aterm().unwrap().unwrap(),
+                    "The read term must match the term that we have written"
+                );
+            }
+        });
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Miri is too slow
+    fn test_random_chunked_stream_truncated() {
+        random_test(25, |rng| {
+            let input = random_terms(rng, 9);
+            let mut stream: Vec<u8> = Vec::new();
+
+            let mut output_stream = ChunkedATermWriter::with_chunk_size(&mut stream, 1, 3).unwrap();
+            for term in &input {
+                output_stream.write_aterm(term).unwrap();
+            }
+            ATermWrite::flush(&mut output_stream).expect("Flushing the output to the stream");
+            drop(output_stream);
+
+            // Drop bytes from the tail; all complete chunks must remain readable.
+            stream.truncate(stream.len() - rng.random_range(1..stream.len() / 3));
+
+            let mut input_stream = ChunkedATermReader::new(&stream[..]).unwrap();
+            let mut read = 0;
+            while let Some(term) = input_stream.read_aterm().unwrap() {
+                assert_eq!(
+                    input[read], term,
+                    "The read term must match the term that we have written"
+                );
+                read += 1;
+            }
+
+            assert!(read % 3 == 0 && read < input.len(), "Only complete chunks can be read");
+        });
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Miri is too slow
+    fn test_random_chunked_stream_skip_to_last_chunk() {
+        random_test(25, |rng| {
+            let input = random_terms(rng, 9);
+            let mut stream: Vec<u8> = Vec::new();
+
+            let mut output_stream = ChunkedATermWriter::with_chunk_size(&mut stream, 1, 3).unwrap();
+            for term in &input {
+                output_stream.write_aterm(term).unwrap();
+            }
+            ATermWrite::flush(&mut output_stream).expect("Flushing the output to the stream");
+            drop(output_stream);
+
+            let mut input_stream = ChunkedATermReader::new(&stream[..]).unwrap();
+            let skipped = input_stream.skip_to_last_chunk().unwrap();
+            assert_eq!(skipped, 6, "All but the last chunk must be skipped");
+
+            for term in &input[skipped..] {
+                assert_eq!(
+                    *term,
+                    input_stream.read_aterm().unwrap().unwrap(),
+                    "The read term must match the term that we have written"
+                );
+            }
+        });
+    }
+}
@@ -3,6 +3,7 @@
 mod aterm;
 mod aterm_binary_stream;
 mod aterm_builder;
+mod aterm_chunked_stream;
 mod aterm_int;
 mod aterm_list;
 mod aterm_string;
@@ -18,6 +19,7 @@ pub mod storage;
 pub use aterm::*;
 pub use aterm_binary_stream::*;
 pub use aterm_builder::*;
+pub use aterm_chunked_stream::*;
 pub use aterm_int::*;
 pub use aterm_list::*;
 pub use aterm_string::*;
@@ -17,10 +17,10 @@ pub fn random_term(rng: &mut impl Rng, symbols: &[(String, usize)], constants: &
     debug_assert!(!constants.is_empty(), "We need constants to be able to create a term");
 
     let mut subterms = THREAD_TERM_POOL.with_borrow(|tp| {
-        FxHashSet::<ATerm>::from_iter(constants.iter().map(|name| {
-            let symbol = tp.create_symbol(name, 0);
+        let symbols = tp.create_symbols(constants.iter().map(|name| (name, 0)));
+        FxHashSet::<ATerm>::from_iter(symbols.iter().map(|symbol| {
             let a: &[ATerm] = &[];
-            tp.create_term(&symbol, a).protect()
+            tp.create_term(symbol, a).protect()
         }))
     });
 
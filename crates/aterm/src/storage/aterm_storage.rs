@@ -59,6 +59,25 @@ impl ATermStorage {
         self.terms.retain(|term| f(term));
     }
 
+    /// Same as [ATermStorage::retain], but sweeps the shards of the term table
+    /// with the given number of worker threads.
+    pub fn retain_parallel<F>(&self, threads: usize, f: F)
+    where
+        F: Fn(&StablePointer<SharedTerm>) -> bool + Sync,
+    {
+        self.terms.retain_parallel(threads, f);
+    }
+
+    /// Removes a single term as part of a sweep over the young generation.
+    ///
+    /// # Safety
+    ///
+    /// The term must be unreachable after the sweep and all remaining
+    /// references to it must be dropped without being dereferenced.
+    pub unsafe fn remove(&self, index: ATermIndex) -> bool {
+        unsafe { self.terms.remove_sweep(index) }
+    }
+
     pub unsafe fn insert_equiv_dst<'a, Q, C>(
         &self,
         value: &'a Q,
@@ -13,7 +13,9 @@ use merc_io::LargeFormatter;
 use merc_sharedmutex::GlobalBfSharedMutex;
 use merc_sharedmutex::RecursiveLockReadGuard;
 use merc_unsafety::StablePointer;
+use merc_utilities::count;
 use merc_utilities::debug_trace;
+use merc_utilities::record_duration;
 
 use crate::ATermIndex;
 use crate::ATermRef;
@@ -57,6 +59,14 @@ pub struct GlobalTermPool {
     marked_symbols: HashSet<SymbolIndex>,
     /// A stack used to mark terms recursively.
     stack: Vec<ATermIndex>,
+    /// Used to avoid reallocations for the young generation during minor collections.
+    young_terms: HashSet<ATermIndex>,
+    /// The number of terms at the end of the last major collection, used to
+    /// decide between minor and major collections.
+    last_major_len: usize,
+    /// Incremented on every collection; used by the thread-local term caches
+    /// to detect that their unprotected indices may have been collected.
+    collection_generation: usize,
 
     /// Deletion hooks called whenever a term with the given head symbol is deleted.
     deletion_hooks: Vec<(Symbol, DeletionHook)>,
@@ -88,6 +98,9 @@ impl GlobalTermPool {
             marked_terms: HashSet::new(),
             marked_symbols: HashSet::new(),
             stack: Vec::new(),
+            young_terms: HashSet::new(),
+            last_major_len: 0,
+            collection_generation: 0,
             deletion_hooks: Vec::new(),
             garbage_collection: true,
             int_symbol,
@@ -153,13 +166,26 @@ impl GlobalTermPool {
     }
 
     /// Create a function symbol
-    pub fn create_symbol<P>(&self, name: impl Into<String> + AsRef<str>, arity: usize, protect: P) -> Symbol
+    pub fn create_symbol<P>(&self, name: impl AsRef<str>, arity: usize, protect: P) -> Symbol
     where
         P: FnOnce(SymbolIndex) -> Symbol,
     {
         protect(self.symbol_pool.create(name, arity))
     }
 
+    /// Create a function symbol for every (name, arity) pair in the batch.
+    pub fn create_symbols<N, I, P>(&self, symbols: I, mut protect: P) -> Vec<Symbol>
+    where
+        N: AsRef<str>,
+        I: IntoIterator<Item = (N, usize)>,
+        P: FnMut(SymbolIndex) -> Symbol,
+    {
+        symbols
+            .into_iter()
+            .map(|(name, arity)| protect(self.symbol_pool.create(name, arity)))
+            .collect()
+    }
+
     /// Registers a new thread term pool.
     ///
     /// # Safety
@@ -172,6 +198,7 @@ impl GlobalTermPool {
             protection_set: ProtectionSet::new(),
             symbol_protection_set: ProtectionSet::new(),
             container_protection_set: ProtectionSet::new(),
+            young_terms: Vec::new(),
             index: self.thread_pools.len(),
         }));
 
@@ -197,7 +224,9 @@ impl GlobalTermPool {
             return 1;
         }
 
-        self.len()
+        // Minor collections are cheap, so trigger the next collection after a
+        // nursery worth of new terms instead of a full table worth.
+        (self.len() / 10).max(1000)
     }
 
     /// Returns a counter for the unique numeric suffix of the given prefix.
@@ -224,17 +253,145 @@ impl GlobalTermPool {
     }
 
     /// Collects garbage terms.
+    ///
+    /// Performs a minor collection over the young generation, unless the table
+    /// has grown substantially since the last major collection in which case a
+    /// full mark-and-sweep is performed.
     fn collect_garbage(&mut self) {
         if !self.garbage_collection {
             // Garbage collection is disabled.
             return;
         }
 
+        // Both collections remove terms, so the thread-local term caches must
+        // be invalidated afterwards.
+        self.collection_generation += 1;
+
+        if self.len() >= 2 * self.last_major_len {
+            self.collect_garbage_major();
+            self.last_major_len = self.len();
+        } else {
+            self.collect_garbage_minor();
+        }
+    }
+
+    /// Returns the number of collections performed so far.
+    pub(crate) fn collection_generation(&self) -> usize {
+        self.collection_generation
+    }
+
+    /// Performs a minor collection: only the terms created since the last
+    /// collection are considered. Since terms are immutable the old generation
+    /// can never refer to young terms, so marking stops at old terms and the
+    /// sweep only visits the young generation. Survivors are promoted by
+    /// clearing the young generation; symbols are only collected by major
+    /// collections.
+    fn collect_garbage_minor(&mut self) {
+        // Clear marking data structures
+        self.marked_terms.clear();
+        self.stack.clear();
+        self.young_terms.clear();
+
+        // Gather the young generation of every thread.
+        for pool in self.thread_pools.iter().flatten() {
+            // SAFETY: We have exclusive access to the global term pool, so no other thread can modify the protection sets.
+            let pool = unsafe { &*pool.get() };
+            for term in &pool.young_terms {
+                self.young_terms.insert(term.copy());
+            }
+        }
+
+        let mark_time = Instant::now();
+
+        let mut marker = Marker {
+            marked_terms: &mut self.marked_terms,
+            marked_symbols: &mut self.marked_symbols,
+            stack: &mut self.stack,
+            young_terms: Some(&self.young_terms),
+        };
+
+        // Loop through all protection sets and mark the young terms.
+        for pool in self.thread_pools.iter().flatten() {
+            // SAFETY: We have exclusive access to the global term pool, so no other thread can modify the protection sets.
+            let pool = unsafe { &mut *pool.get() };
+
+            for (_root, term) in pool.protection_set.iter() {
+                debug_trace!("Marking root {_root} term {term:?}");
+                unsafe {
+                    ATermRef::from_index(term).mark(&mut marker);
+                }
+            }
+
+            for (_, container) in pool.container_protection_set.iter() {
+                container.mark(&mut marker);
+            }
+        }
+
+        let mark_time_elapsed = mark_time.elapsed();
+        let collect_time = Instant::now();
+
+        let num_of_terms = self.len();
+
+        // Sweep the dead young terms and promote the survivors. Iterating the
+        // young generation in reverse creation order removes terms before
+        // their arguments.
+        for pool in self.thread_pools.iter().flatten() {
+            // SAFETY: We have exclusive access to the global term pool, so no other thread can modify the protection sets.
+            let pool = unsafe { &mut *pool.get() };
+
+            for term in pool.young_terms.drain(..).rev() {
+                if !self.marked_terms.contains(&term) {
+                    debug_trace!("Dropping term: {:?}", term);
+
+                    // Call the deletion hooks for the term
+                    for (symbol, hook) in &self.deletion_hooks {
+                        if symbol == term.symbol() {
+                            debug_trace!("Calling deletion hook for term: {:?}", term);
+                            hook(&term);
+                        }
+                    }
+
+                    // SAFETY: The term is unmarked, so it is unreachable; the
+                    // remaining copies in the marking structures are cleared
+                    // without being dereferenced.
+                    unsafe {
+                        self.terms.remove(term);
+                    }
+                }
+            }
+        }
+
+        count("aterm.minor_collections", 1);
+        record_duration("aterm.minor_collection_mark", mark_time_elapsed.as_secs_f64());
+        record_duration("aterm.minor_collection_sweep", collect_time.elapsed().as_secs_f64());
+
+        debug!(
+            "Minor garbage collection: marking took {}ms, collection took {}ms, {} terms removed",
+            mark_time_elapsed.as_millis(),
+            collect_time.elapsed().as_millis(),
+            num_of_terms - self.len(),
+        );
+
+        // The young generation still contains pointers to removed terms, clear
+        // them before any other collection can take place.
+        self.young_terms.clear();
+        self.marked_terms.clear();
+    }
+
+    /// Performs a major collection: a full mark-and-sweep over all terms and symbols.
+    fn collect_garbage_major(&mut self) {
         // Clear marking data structures
         self.marked_terms.clear();
         self.marked_symbols.clear();
         self.stack.clear();
 
+        // All surviving terms are part of the old generation afterwards.
+        for pool in self.thread_pools.iter().flatten() {
+            // SAFETY: We have exclusive access to the global term pool, so no other thread can modify the protection sets.
+            let pool = unsafe { &mut *pool.get() };
+            pool.young_terms.clear();
+        }
+
         // Mark the default symbols
         self.marked_symbols.insert(self.int_symbol.shared().copy());
         self.marked_symbols.insert(self.list_symbol.shared().copy());
@@ -244,6 +401,7 @@ impl GlobalTermPool {
             marked_terms: &mut self.marked_terms,
             marked_symbols: &mut self.marked_symbols,
             stack: &mut self.stack,
+            young_terms: None,
         };
 
         let mark_time = Instant::now();
@@ -277,8 +435,11 @@ impl GlobalTermPool {
         let num_of_terms = self.len();
         let num_of_symbols = self.symbol_pool.len();
 
-        // Delete all terms that are not marked
-        self.terms.retain(|term| {
+        // Delete all terms that are not marked. The marking is read-only and
+        // the deletion hooks are Sync, so the shards of the term table can be
+        // swept by one worker per registered thread.
+        let threads = self.thread_pools.iter().flatten().count().max(1);
+        self.terms.retain_parallel(threads, |term| {
             if !self.marked_terms.contains(term) {
                 debug_trace!("Dropping term: {:?}", term);
 
@@ -306,6 +467,10 @@ impl GlobalTermPool {
             true
         });
 
+        count("aterm.major_collections", 1);
+        record_duration("aterm.major_collection_mark", mark_time_elapsed.as_secs_f64());
+        record_duration("aterm.major_collection_sweep", collect_time.elapsed().as_secs_f64());
+
         debug!(
             "Garbage collection: marking took {}ms, collection took {}ms, {} terms and {} symbols removed",
             mark_time_elapsed.as_millis(),
@@ -340,6 +505,7 @@ impl GlobalTermPool {
             marked_terms: &mut self.marked_terms,
             marked_symbols: &mut self.marked_symbols,
             stack: &mut self.stack,
+            young_terms: None,
         };
         term.mark(&mut marker);
     }
@@ -380,6 +546,9 @@ pub struct SharedTermProtection {
     pub symbol_protection_set: ProtectionSet<SymbolIndex>,
     /// Protection set for containers
     pub container_protection_set: ProtectionSet<Arc<dyn Markable + Sync + Send>>,
+    /// The young generation: terms created by this thread since the last
+    /// collection. Minor collections only sweep these terms.
+    pub young_terms: Vec<ATermIndex>,
     /// Index in global pool's thread pools list
     pub index: usize,
 }
@@ -428,12 +597,16 @@ pub struct Marker<'a> {
     marked_terms: &'a mut HashSet<ATermIndex>,
     marked_symbols: &'a mut HashSet<SymbolIndex>,
     stack: &'a mut Vec<ATermIndex>,
+    /// During a minor collection only the young generation is considered.
+    /// Since terms are immutable an old term can never refer to a young term,
+    /// so marking can stop at the old generation.
+    young_terms: Option<&'a HashSet<ATermIndex>>,
 }
 
 impl Marker<'_> {
     // Marks the given term as being reachable.
     pub fn mark(&mut self, term: &ATermRef<'_>) {
-        if !self.marked_terms.contains(term.shared()) {
+        if self.is_candidate(term.shared()) && !self.marked_terms.contains(term.shared()) {
             self.stack.push(term.shared().copy());
 
             while let Some(term) = self.stack.pop() {
@@ -446,7 +619,7 @@ impl Marker<'_> {
                 // For some terms, such as ATermInt, we must ONLY consider the valid arguments (indicated by the arity)
                 for arg in term.arguments()[0..term.symbol().arity()].iter() {
                     // Skip if unnecessary, otherwise mark before pushing to stack since it can be shared.
-                    if !self.marked_terms.contains(arg.shared()) {
+                    if self.is_candidate(arg.shared()) && !self.marked_terms.contains(arg.shared()) {
                         self.marked_terms.insert(arg.shared().copy());
                         self.marked_symbols.insert(arg.get_head_symbol().shared().copy());
                         self.stack.push(arg.shared().copy());
@@ -456,6 +629,11 @@ impl Marker<'_> {
         }
     }
 
+    /// Returns true iff the given term has to be marked by this collection.
+    fn is_candidate(&self, term: &ATermIndex) -> bool {
+        self.young_terms.is_none_or(|young| young.contains(term))
+    }
+
     /// Marks the given symbol as being reachable.
     pub fn mark_symbol(&mut self, symbol: &SymbolRef<'_>) {
         self.marked_symbols.insert(symbol.shared().copy());
@@ -470,6 +648,32 @@ mod tests {
 
     use crate::random_term;
 
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_generational_garbage_collection() {
+        random_test(10, |rng| {
+            let kept = random_term(rng, &[("f".into(), 2), ("g".into(), 1)], &["a".to_string()], 10);
+            let representation = format!("{}", kept);
+
+            // Create short-lived terms and force collections; the first
+            // collection is a major one and subsequent ones are minor.
+            for _ in 0..10 {
+                for _ in 0..100 {
+                    let _term = random_term(rng, &[("h".into(), 2), ("i".into(), 1)], &["b".to_string()], 10);
+                }
+
+                super::GLOBAL_TERM_POOL
+                    .share()
+                    .write()
+                    .expect("Lock poisoned!")
+                    .trigger_garbage_collection();
+            }
+
+            // The protected term must have been promoted and survive all collections.
+            assert_eq!(format!("{}", kept), representation);
+        });
+    }
+
     #[test]
     #[cfg_attr(miri, ignore)]
     fn test_maximal_sharing() {
@@ -41,7 +41,7 @@ impl SymbolPool {
     /// Creates or retrieves a function symbol with the given name and arity.
     pub fn create<N>(&self, name: N, arity: usize) -> StablePointer<SharedSymbol>
     where
-        N: Into<String> + AsRef<str>,
+        N: AsRef<str>,
     {
         // Get or create symbol index
         let (shared_symbol, inserted) = self.symbols.insert_equiv(&SharedSymbolLookup { name, arity });
@@ -160,23 +160,23 @@ impl SymbolPool {
 #[derive(Debug, Clone, Eq, PartialEq)]
 pub struct SharedSymbol {
     /// Name of the function
-    name: String,
+    name: SymbolName,
     /// Number of arguments
     arity: usize,
 }
 
 impl SharedSymbol {
     /// Creates a new function symbol.
-    pub fn new(name: impl Into<String>, arity: usize) -> Self {
+    pub fn new(name: impl AsRef<str>, arity: usize) -> Self {
         Self {
-            name: name.into(),
+            name: SymbolName::from(name.as_ref()),
             arity,
         }
     }
 
     /// Returns the name of the function symbol
     pub fn name(&self) -> &str {
-        &self.name
+        self.name.as_str()
     }
 
     /// Returns the arity of the function symbol
@@ -190,28 +190,100 @@ impl SharedSymbol {
     }
 }
 
+/// The name of a function symbol. Names of at most [SymbolName::INLINE_CAPACITY]
+/// bytes, the overwhelming majority in practice, are stored inline to avoid a
+/// heap allocation per symbol and a pointer chase when comparing names.
+#[derive(Debug, Clone)]
+enum SymbolName {
+    /// A short name stored directly in the symbol, padded with zero bytes.
+    Inline {
+        length: u8,
+        bytes: [u8; SymbolName::INLINE_CAPACITY],
+    },
+    /// A name that does not fit inline, stored on the heap.
+    Heap(Box<str>),
+}
+
+impl SymbolName {
+    /// Chosen such that `SymbolName` is no larger than the `String` it replaces.
+    const INLINE_CAPACITY: usize = 22;
+
+    /// Returns the name as a string slice.
+    fn as_str(&self) -> &str {
+        match self {
+            SymbolName::Inline { length, bytes } => {
+                // The bytes were copied from a str, so they are valid UTF-8.
+                std::str::from_utf8(&bytes[..*length as usize]).expect("Inline symbol names are valid UTF-8")
+            }
+            SymbolName::Heap(name) => name,
+        }
+    }
+}
+
+impl From<&str> for SymbolName {
+    fn from(name: &str) -> Self {
+        if name.len() <= Self::INLINE_CAPACITY {
+            let mut bytes = [0; Self::INLINE_CAPACITY];
+            bytes[..name.len()].copy_from_slice(name.as_bytes());
+            SymbolName::Inline {
+                length: name.len() as u8,
+                bytes,
+            }
+        } else {
+            SymbolName::Heap(name.into())
+        }
+    }
+}
+
+impl PartialEq for SymbolName {
+    fn eq(&self, other: &Self) -> bool {
+        match (self, other) {
+            (
+                SymbolName::Inline { length, bytes },
+                SymbolName::Inline {
+                    length: other_length,
+                    bytes: other_bytes,
+                },
+            ) => {
+                // The unused bytes are zero, so comparing the full arrays compares the names.
+                length == other_length && bytes == other_bytes
+            }
+            (SymbolName::Heap(name), SymbolName::Heap(other_name)) => name == other_name,
+            // Names are stored inline exactly when they fit, so the variants never overlap.
+            _ => false,
+        }
+    }
+}
+
+impl Eq for SymbolName {}
+
+/// Must be equal to hashing the name as a str, see `SharedSymbolLookup`.
+impl Hash for SymbolName {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        self.as_str().hash(state);
+    }
+}
+
 /// A cheap way to look up SharedSymbol
-struct SharedSymbolLookup<T: Into<String> + AsRef<str>> {
+struct SharedSymbolLookup<T: AsRef<str>> {
     name: T,
     arity: usize,
 }
 
-impl<T: Into<String> + AsRef<str>> From<&SharedSymbolLookup<T>> for SharedSymbol {
+impl<T: AsRef<str>> From<&SharedSymbolLookup<T>> for SharedSymbol {
     fn from(lookup: &SharedSymbolLookup<T>) -> Self {
-        // TODO: Not optimal
-        let string = lookup.name.as_ref().to_string();
-        Self::new(string, lookup.arity)
+        Self::new(lookup.name.as_ref(), lookup.arity)
     }
 }
 
-impl<T: Into<String> + AsRef<str>> Equivalent<SharedSymbol> for SharedSymbolLookup<T> {
+impl<T: AsRef<str>> Equivalent<SharedSymbol> for SharedSymbolLookup<T> {
     fn equivalent(&self, other: &SharedSymbol) -> bool {
-        self.name.as_ref() == other.name && self.arity == other.arity
+        self.name.as_ref() == other.name.as_str() && self.arity == other.arity
     }
 }
 
 /// These hash implementations should be the same as `SharedSymbol`.
-impl<T: Into<String> + AsRef<str>> Hash for SharedSymbolLookup<T> {
+impl<T: AsRef<str>> Hash for SharedSymbolLookup<T> {
     fn hash<H: Hasher>(&self, state: &mut H) {
         self.name.as_ref().hash(state);
         self.arity.hash(state);
@@ -229,6 +301,7 @@ impl Hash for SharedSymbol {
 mod tests {
     use std::sync::atomic::Ordering;
 
+    use crate::Symb;
     use crate::Symbol;
     use crate::storage::THREAD_TERM_POOL;
 
@@ -243,6 +316,31 @@ mod tests {
         assert_eq!(f1, f2);
     }
 
+    #[test]
+    fn test_symbol_long_name() {
+        let _ = merc_utilities::test_logger();
+
+        // A name beyond the inline capacity is stored on the heap, sharing must still work.
+        let name = "a_function_symbol_with_a_name_that_does_not_fit_inline";
+        let f1 = Symbol::new(name, 1);
+        let f2 = Symbol::new(name, 1);
+
+        assert_eq!(f1, f2);
+        assert_eq!(f1.name(), name);
+    }
+
+    #[test]
+    fn test_symbol_batch() {
+        let _ = merc_utilities::test_logger();
+
+        let symbols = Symbol::new_many([("f", 2), ("g", 1), ("f", 2)]);
+
+        assert_eq!(symbols[0].name(), "f");
+        assert_eq!(symbols[1].name(), "g");
+        assert_eq!(symbols[0], symbols[2]);
+        assert_ne!(symbols[0], symbols[1]);
+    }
+
     #[test]
     fn test_prefix_counter() {
         let _ = merc_utilities::test_logger();
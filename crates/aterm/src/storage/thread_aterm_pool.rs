@@ -9,17 +9,20 @@ use log::debug;
 
 use merc_collections::ProtectionIndex;
 use merc_pest_consume::Parser;
+use rustc_hash::FxHashMap;
 use merc_sharedmutex::RecursiveLock;
 use merc_sharedmutex::RecursiveLockReadGuard;
 use merc_unsafety::StablePointer;
 use merc_utilities::MercError;
 use merc_utilities::debug_trace;
 
+use crate::ATermIndex;
 use crate::Markable;
 use crate::Return;
 use crate::Rule;
 use crate::Symb;
 use crate::Symbol;
+use crate::SymbolIndex;
 use crate::SymbolRef;
 use crate::Term;
 use crate::TermParser;
@@ -36,6 +39,16 @@ thread_local! {
     pub static THREAD_TERM_POOL: RefCell<ThreadTermPool> = RefCell::new(ThreadTermPool::new());
 }
 
+/// The maximum number of entries in the thread-local term cache.
+const TERM_CACHE_CAPACITY: usize = 1 << 16;
+
+/// The lookup key of the thread-local term cache.
+#[derive(PartialEq, Eq, Hash)]
+struct TermCacheKey {
+    symbol: SymbolIndex,
+    arguments: Vec<ATermIndex>,
+}
+
 /// Per-thread term pool managing local protection sets.
 pub struct ThreadTermPool {
     /// A reference to the protection set of this thread pool.
@@ -47,6 +60,21 @@ pub struct ThreadTermPool {
     /// A vector of terms that are used to store the arguments of a term for loopup.
     tmp_arguments: RefCell<Vec<ATermRef<'static>>>,
 
+    /// A thread-local cache from (symbol, arguments) to the shared term index,
+    /// consulted before the shared unique table. The stored indices are not
+    /// protected, so the cache is flushed whenever a collection has happened.
+    term_cache: RefCell<FxHashMap<TermCacheKey, ATermIndex>>,
+
+    /// The collection generation for which the term cache is valid.
+    term_cache_generation: Cell<usize>,
+
+    /// A reusable buffer for building the cache lookup key.
+    term_cache_arguments: Cell<Vec<ATermIndex>>,
+
+    /// The number of hits and misses of the term cache.
+    term_cache_hits: Cell<usize>,
+    term_cache_misses: Cell<usize>,
+
     /// A local view for the global term pool.
     term_pool: RecursiveLock<GlobalTermPool>,
 
@@ -68,6 +96,7 @@ impl ThreadTermPool {
         let int_symbol = pool.get_int_symbol().copy();
         let empty_list_symbol = pool.get_empty_list_symbol().copy();
         let list_symbol = pool.get_list_symbol().copy();
+        let collection_generation = pool.collection_generation();
         drop(pool);
 
         // Arbitrary value to trigger garbage collection
@@ -75,6 +104,11 @@ impl ThreadTermPool {
             protection_set,
             garbage_collection_counter: Cell::new(if AGGRESSIVE_GC { 1 } else { 1000 }),
             tmp_arguments: RefCell::new(Vec::new()),
+            term_cache: RefCell::new(FxHashMap::default()),
+            term_cache_generation: Cell::new(collection_generation),
+            term_cache_arguments: Cell::new(Vec::new()),
+            term_cache_hits: Cell::new(0),
+            term_cache_misses: Cell::new(0),
             int_symbol,
             empty_list_symbol,
             list_symbol,
@@ -82,6 +116,66 @@ impl ThreadTermPool {
         }
     }
 
+    /// Creates a term through the thread-local term cache.
+    ///
+    /// On a hit the shared unique table is not consulted at all; a miss falls
+    /// through to the shared table and the result is cached. The stored
+    /// indices are unprotected, so the cache is flushed at this safepoint when
+    /// a garbage collection has happened since the previous lookup.
+    fn create_term_array_cached<'a, 'b>(
+        &self,
+        guard: &RecursiveLockReadGuard<'_, GlobalTermPool>,
+        symbol: &'b impl Symb<'a, 'b>,
+        arguments: &[ATermRef<'static>],
+    ) -> (ATermIndex, bool) {
+        let generation = guard.collection_generation();
+        if self.term_cache_generation.get() != generation {
+            self.term_cache.borrow_mut().clear();
+            self.term_cache_generation.set(generation);
+        }
+
+        // Build the lookup key in a reusable buffer, so that cache hits do not allocate.
+        let mut buffer = self.term_cache_arguments.take();
+        buffer.clear();
+        buffer.extend(arguments.iter().map(|argument| argument.shared().copy()));
+        let key = TermCacheKey {
+            symbol: symbol.shared().copy(),
+            arguments: buffer,
+        };
+
+        let mut cache = self.term_cache.borrow_mut();
+        if let Some(index) = cache.get(&key) {
+            let index = index.copy();
+            self.term_cache_hits.set(self.term_cache_hits.get() + 1);
+            self.term_cache_arguments.set(key.arguments);
+            return (index, false);
+        }
+
+        self.term_cache_misses.set(self.term_cache_misses.get() + 1);
+        let (index, inserted) = guard.create_term_array(symbol, arguments);
+
+        // Keep the cache small; misses already pay for the shared table.
+        if cache.len() >= TERM_CACHE_CAPACITY {
+            cache.clear();
+        }
+
+        cache.insert(
+            TermCacheKey {
+                symbol: key.symbol.copy(),
+                arguments: key.arguments.iter().map(|argument| argument.copy()).collect(),
+            },
+            index.copy(),
+        );
+        self.term_cache_arguments.set(key.arguments);
+
+        (index, inserted)
+    }
+
+    /// Returns the number of hits and misses of the thread-local term cache.
+    pub fn term_cache_metrics(&self) -> (usize, usize) {
+        (self.term_cache_hits.get(), self.term_cache_misses.get())
+    }
+
     /// Creates a term without arguments.
     pub fn create_constant(&self, symbol: &SymbolRef<'_>) -> ATerm {
         assert!(symbol.arity() == 0, "A constant should not have arity > 0");
@@ -89,9 +183,10 @@ impl ThreadTermPool {
         let empty_args: [ATermRef<'_>; 0] = [];
         let guard = self.term_pool.read_recursive().expect("Lock poisoned!");
 
-        let (index, inserted) = guard.create_term_array(symbol, &empty_args);
+        let (index, inserted) = self.create_term_array_cached(&guard, symbol, &empty_args);
 
         if inserted {
+            self.record_young_term(&index);
             self.trigger_garbage_collection();
         }
 
@@ -115,9 +210,10 @@ impl ThreadTermPool {
 
         let guard = self.term_pool.read_recursive().expect("Lock poisoned!");
 
-        let (index, inserted) = guard.create_term_array(symbol, &arguments);
+        let (index, inserted) = self.create_term_array_cached(&guard, symbol, &arguments);
 
         if inserted {
+            self.record_young_term(&index);
             self.trigger_garbage_collection();
         }
 
@@ -137,6 +233,7 @@ impl ThreadTermPool {
         let (index, inserted) = guard.create_int(value);
 
         if inserted {
+            self.record_young_term(&index);
             self.trigger_garbage_collection();
         }
 
@@ -159,9 +256,10 @@ impl ThreadTermPool {
 
         let guard = self.term_pool.read_recursive().expect("Lock poisoned!");
 
-        let (index, inserted) = guard.create_term_array(symbol, &arguments);
+        let (index, inserted) = self.create_term_array_cached(&guard, symbol, &arguments);
 
         if inserted {
+            self.record_young_term(&index);
             self.trigger_garbage_collection();
         }
 
@@ -188,9 +286,10 @@ impl ThreadTermPool {
 
         let guard = self.term_pool.read_recursive().expect("Lock poisoned!");
 
-        let (index, inserted) = guard.create_term_array(symbol, &arguments);
+        let (index, inserted) = self.create_term_array_cached(&guard, symbol, &arguments);
 
         if inserted {
+            self.record_young_term(&index);
             self.trigger_garbage_collection();
         }
 
@@ -221,9 +320,10 @@ impl ThreadTermPool {
 
         let guard = self.term_pool.read_recursive().expect("Lock poisoned!");
 
-        let (index, inserted) = guard.create_term_array(symbol, &arguments);
+        let (index, inserted) = self.create_term_array_cached(&guard, symbol, &arguments);
 
         if inserted {
+            self.record_young_term(&index);
             self.trigger_garbage_collection();
         }
 
@@ -231,7 +331,7 @@ impl ThreadTermPool {
     }
 
     /// Create a function symbol
-    pub fn create_symbol(&self, name: impl Into<String> + AsRef<str>, arity: usize) -> Symbol {
+    pub fn create_symbol(&self, name: impl AsRef<str>, arity: usize) -> Symbol {
         self.term_pool
             .read_recursive()
             .expect("Lock poisoned!")
@@ -240,6 +340,24 @@ impl ThreadTermPool {
             })
     }
 
+    /// Create a function symbol for every (name, arity) pair in the batch.
+    ///
+    /// Acquires the global term pool lock and the protection set lock once for
+    /// the whole batch, so bursts of symbols avoid the per-symbol locking of
+    /// [ThreadTermPool::create_symbol].
+    pub fn create_symbols<N, I>(&self, symbols: I) -> Vec<Symbol>
+    where
+        N: AsRef<str>,
+        I: IntoIterator<Item = (N, usize)>,
+    {
+        let guard = self.term_pool.read_recursive().expect("Lock poisoned!");
+        let mut lock = self.lock_protection_set();
+
+        guard.create_symbols(symbols, |index| unsafe {
+            Symbol::from_index(&index, lock.symbol_protection_set.protect(index.copy()))
+        })
+    }
+
     /// Protect the term by adding its index to the protection set
     pub fn protect(&self, term: &ATermRef<'_>) -> ATerm {
         // Protect the term by adding its index to the protection set
@@ -388,6 +506,15 @@ impl ThreadTermPool {
             .replace(root, term);
     }
 
+    /// Records a newly created term in the young generation of this thread,
+    /// which is used by minor garbage collections.
+    ///
+    /// Must be called while the global term pool is locked.
+    fn record_young_term(&self, index: &ATermIndex) {
+        // SAFETY: The global term pool is locked, so we can safely access the protection set.
+        unsafe { &mut *self.protection_set.get() }.young_terms.push(index.copy());
+    }
+
     /// This triggers the global garbage collection based on heuristics.
     fn trigger_garbage_collection(&self) {
         // If the term was newly inserted, decrease the garbage collection counter and trigger garbage collection if necessary
@@ -428,6 +555,11 @@ impl Drop for ThreadTermPool {
         write.deregister_thread_pool(self.index());
 
         debug!("{}", unsafe { &mut *self.protection_set.get() }.metrics());
+        debug!(
+            "Thread-local term cache: {} hits and {} misses",
+            self.term_cache_hits.get(),
+            self.term_cache_misses.get()
+        );
         debug!(
             "Acquired {} read locks and {} write locks",
             self.term_pool.read_recursive_call_count(),
@@ -500,6 +632,42 @@ mod tests {
         });
     }
 
+    #[test]
+    fn test_term_cache() {
+        let _ = merc_utilities::test_logger();
+
+        // Use a dedicated thread since other tests may share the thread pool.
+        thread::scope(|scope| {
+            scope.spawn(|| {
+                let f = Symbol::new("f", 1);
+                let a = ATerm::constant(&Symbol::new("a", 0));
+
+                let first = THREAD_TERM_POOL.with_borrow(|tp| tp.create_term(&f, std::slice::from_ref(&a)).protect());
+                let (_, misses) = THREAD_TERM_POOL.with_borrow(|tp| tp.term_cache_metrics());
+
+                // Creating the same term again must be served by the cache.
+                let second =
+                    THREAD_TERM_POOL.with_borrow(|tp| tp.create_term(&f, std::slice::from_ref(&a)).protect());
+                let (hits, misses_after) = THREAD_TERM_POOL.with_borrow(|tp| tp.term_cache_metrics());
+
+                assert_eq!(first, second, "The cached term must be the shared term");
+                assert!(hits >= 1, "The second creation must be a cache hit");
+                assert_eq!(misses, misses_after, "The second creation must not be a cache miss");
+
+                // A garbage collection flushes the cache, after which creation must still work.
+                GLOBAL_TERM_POOL
+                    .share()
+                    .write()
+                    .expect("Lock poisoned!")
+                    .trigger_garbage_collection();
+
+                let third =
+                    THREAD_TERM_POOL.with_borrow(|tp| tp.create_term(&f, std::slice::from_ref(&a)).protect());
+                assert_eq!(first, third, "The term must be shared across collections");
+            });
+        });
+    }
+
     #[test]
     fn test_parsing() {
         let _ = merc_utilities::test_logger();
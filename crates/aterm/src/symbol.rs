@@ -146,9 +146,18 @@ pub struct Symbol {
 
 impl Symbol {
     /// Create a new symbol with the given name and arity.
-    pub fn new(name: impl Into<String> + AsRef<str>, arity: usize) -> Symbol {
+    pub fn new(name: impl AsRef<str>, arity: usize) -> Symbol {
         THREAD_TERM_POOL.with_borrow(|tp| tp.create_symbol(name, arity))
     }
+
+    /// Create a symbol for every (name, arity) pair in the batch, taking the
+    /// necessary locks only once. See [crate::storage::ThreadTermPool::create_symbols].
+    pub fn new_many<N>(symbols: impl IntoIterator<Item = (N, usize)>) -> Vec<Symbol>
+    where
+        N: AsRef<str>,
+    {
+        THREAD_TERM_POOL.with_borrow(|tp| tp.create_symbols(symbols))
+    }
 }
 
 impl Symbol {
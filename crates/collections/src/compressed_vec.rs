@@ -86,6 +86,53 @@ impl<T: CompressedEntry> ByteCompressedVec<T> {
         entry.to_bytes(&mut self.data[old_len..]);
     }
 
+    /// Adds all entries of the given slice to the vector.
+    ///
+    /// Unlike repeated [ByteCompressedVec::push] calls this widens the vector
+    /// at most once, reserves the space for all entries up front and encodes
+    /// them into consecutive chunks without any per-entry bookkeeping.
+    pub fn extend_from_slice(&mut self, entries: &[T]) {
+        if entries.is_empty() {
+            return;
+        }
+
+        let bytes_required = entries
+            .iter()
+            .fold(0, |max_bytes, entry| max_bytes.max(entry.bytes_required()));
+        self.resize_entries(bytes_required);
+
+        let old_len = self.data.len();
+        self.data.resize(old_len + entries.len() * self.bytes_per_entry, 0);
+        for (chunk, entry) in self.data[old_len..].chunks_exact_mut(self.bytes_per_entry).zip(entries) {
+            entry.to_bytes(chunk);
+        }
+    }
+
+    /// Decodes the entries in the range starting at `begin` into the given
+    /// slice, the counterpart of [ByteCompressedVec::extend_from_slice].
+    ///
+    /// Decoding consecutive chunks avoids the index computation and bounds
+    /// checks of a per-entry [ByteCompressedVec::index] loop.
+    pub fn decode_into(&self, begin: usize, output: &mut [T]) {
+        if output.is_empty() {
+            return;
+        }
+
+        debug_assert!(
+            begin + output.len() <= self.len(),
+            "The range to decode is out of bounds"
+        );
+
+        let start = begin * self.bytes_per_entry;
+        let end = start + output.len() * self.bytes_per_entry;
+        for (entry, chunk) in output
+            .iter_mut()
+            .zip(self.data[start..end].chunks_exact(self.bytes_per_entry))
+        {
+            *entry = T::from_bytes(chunk);
+        }
+    }
+
     /// Removes the last element from the vector and returns it, or None if it is empty.
     pub fn pop(&mut self) -> Option<T> {
         if self.is_empty() {
@@ -144,19 +191,15 @@ impl<T: CompressedEntry> ByteCompressedVec<T> {
 
     /// Returns an iterator over the elements in the vector.
     pub fn iter(&self) -> ByteCompressedVecIterator<'_, T> {
-        ByteCompressedVecIterator {
-            vector: self,
-            current: 0,
-            end: self.len(),
-        }
+        self.iter_range(0, self.len())
     }
 
     /// Returns an iterator over the elements in the vector for the begin, end range.
     pub fn iter_range(&self, begin: usize, end: usize) -> ByteCompressedVecIterator<'_, T> {
         ByteCompressedVecIterator {
-            vector: self,
-            current: begin,
-            end,
+            remaining: &self.data[begin * self.bytes_per_entry..end * self.bytes_per_entry],
+            bytes_per_entry: self.bytes_per_entry,
+            _marker: PhantomData,
         }
     }
 
@@ -346,11 +389,14 @@ impl<T: CompressedEntry> ByteCompressedVec<T> {
             let mut new_data: Vec<u8> = vec![0; self.len() * new_bytes_required];
 
             if self.bytes_per_entry > 0 {
-                // Resize all the existing elements because the new entry requires more bytes.
-                for (index, entry) in self.iter().enumerate() {
-                    let start = index * new_bytes_required;
-                    let end = start + new_bytes_required;
-                    entry.to_bytes(&mut new_data[start..end]);
+                // Copy every existing entry into the low bytes of its wider
+                // chunk; the remaining bytes stay zero, which yields the wider
+                // representation without decoding and re-encoding every entry.
+                for (new_chunk, old_chunk) in new_data
+                    .chunks_exact_mut(new_bytes_required)
+                    .zip(self.data.chunks_exact(self.bytes_per_entry))
+                {
+                    new_chunk[..self.bytes_per_entry].copy_from_slice(old_chunk);
                 }
             }
 
@@ -406,26 +452,43 @@ impl fmt::Display for CompressedVecMetrics {
         )
     }
 }
+/// An iterator that walks the underlying bytes directly, so that advancing
+/// costs no index computation or bounds check per element.
 pub struct ByteCompressedVecIterator<'a, T> {
-    vector: &'a ByteCompressedVec<T>,
-    current: usize,
-    end: usize,
+    remaining: &'a [u8],
+    bytes_per_entry: usize,
+    _marker: PhantomData<T>,
 }
 
 impl<T: CompressedEntry> Iterator for ByteCompressedVecIterator<'_, T> {
     type Item = T;
 
     fn next(&mut self) -> Option<Self::Item> {
-        if self.current < self.end {
-            let result = self.vector.index(self.current);
-            self.current += 1;
-            Some(result)
-        } else {
+        if self.remaining.is_empty() {
             None
+        } else {
+            let (chunk, remaining) = self.remaining.split_at(self.bytes_per_entry);
+            self.remaining = remaining;
+            Some(T::from_bytes(chunk))
         }
     }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        let length = if self.bytes_per_entry == 0 {
+            0
+        } else {
+            self.remaining.len() / self.bytes_per_entry
+        };
+        (length, Some(length))
+    }
 }
 
+impl<T: CompressedEntry> ExactSizeIterator for ByteCompressedVecIterator<'_, T> {}
+
+/// The byte representation must be a little endian style truncation: the
+/// representation at a larger width is the representation at a smaller width
+/// padded with zero bytes, such that the vector can widen its entries with
+/// plain byte copies.
 pub trait CompressedEntry {
     // Returns the entry as a byte vector
     fn to_bytes(&self, bytes: &mut [u8]);
@@ -561,6 +624,49 @@ mod tests {
         assert_eq!(vec.index(2), 1);
     }
 
+    #[test]
+    fn test_random_extend_from_slice() {
+        random_test(100, |rng| {
+            // The prefix keeps the entries narrow so that the extension triggers a widening.
+            let prefix = (0..rng.random_range(0..10))
+                .map(|_| rng.random_range(0..256))
+                .collect::<Vec<usize>>();
+            let suffix = (0..rng.random_range(0..10))
+                .map(|_| rng.random_range(0..usize::MAX))
+                .collect::<Vec<usize>>();
+
+            let mut vec = ByteCompressedVec::with_iter(prefix.iter().cloned());
+            vec.extend_from_slice(&suffix);
+
+            let mut expected = prefix;
+            expected.extend_from_slice(&suffix);
+
+            assert_eq!(vec.len(), expected.len());
+            for (expected, element) in expected.iter().zip(vec.iter()) {
+                assert_eq!(*expected, element);
+            }
+        });
+    }
+
+    #[test]
+    fn test_random_decode_into() {
+        random_test(100, |rng| {
+            let elements = (0..rng.random_range(1..20))
+                .map(|_| rng.random_range(0..usize::MAX))
+                .collect::<Vec<usize>>();
+
+            let vec = ByteCompressedVec::with_iter(elements.iter().cloned());
+
+            let begin = rng.random_range(0..elements.len());
+            let end = rng.random_range(begin..elements.len());
+
+            let mut output = vec![0usize; end - begin];
+            vec.decode_into(begin, &mut output);
+
+            assert_eq!(&output, &elements[begin..end]);
+        });
+    }
+
     #[test]
     fn test_random_bytevector_permute() {
         random_test(100, |rng| {
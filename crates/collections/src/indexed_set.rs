@@ -114,6 +114,13 @@ impl<T, S> IndexedSet<T, S> {
         self.table.capacity()
     }
 
+    /// Reserves capacity for at least `additional` more elements, avoiding
+    /// repeated reallocations when the number of insertions is known up front.
+    pub fn reserve(&mut self, additional: usize) {
+        self.table.reserve(additional);
+        self.index.reserve(additional);
+    }
+
     /// Returns an iterator over the elements in the set.
     pub fn iter(&self) -> Iter<'_, T, S> {
         Iter {
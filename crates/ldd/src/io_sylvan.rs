@@ -1,73 +1,102 @@
-use std::collections::HashMap;
+//!
+//! # The Sylvan .ldd format:
+//!
+//! Every LDD is written as a `u64` node count, followed by the nodes in
+//! bottom-up order and a `u64` root index. A node consists of two little endian
+//! `u64` words with the layout `RmRR RRRR RRRR VVVV | VVVV DcDD DDDD DDDD`,
+//! where every character is 4 bits, V = value, D = down index, R = right index,
+//! m = marked and c = copy. The indices 0 and 1 are reserved for the empty set
+//! and the empty vector respectively, and node indices are shared between all
+//! LDDs in the same stream.
+//!
+
+use std::cell::RefCell;
 use std::io::Read;
+use std::io::Write;
 
+use merc_collections::IndexedSet;
 use merc_utilities::MercError;
 
+use crate::Data;
 use crate::Ldd;
 use crate::Storage;
 use crate::Value;
+use crate::iterators::iter_nodes;
 
 /// A reader for LDDs in the Sylvan .ldd format.
 pub struct SylvanReader {
-    indexed_set: HashMap<u64, Ldd>, // Assigns LDDs to every index.
-    last_index: u64,                // The index of the last LDD read from file.
+    nodes: Vec<Ldd>, // Assigns LDDs to every index, offset by the two reserved indices.
 }
 
 impl SylvanReader {
     pub fn new() -> Self {
-        Self {
-            indexed_set: HashMap::new(),
-            last_index: 2,
-        }
+        Self { nodes: Vec::new() }
     }
 
     /// Returns an LDD read from the given stream in the Sylvan format.
     pub fn read_ldd(&mut self, storage: &mut Storage, stream: &mut impl Read) -> Result<Ldd, MercError> {
-        let count = read_u64(stream)?;
-        //println!("node count = {}", count);
+        let count = read_u64(stream)? as usize;
+
+        // Read the complete node array at once instead of node-by-node; the
+        // insertions into the node table dominate, so pre-size it as well.
+        let mut buffer = vec![
+            0u8;
+            count
+                .checked_mul(16)
+                .ok_or("The node count overflows the node array size")?
+        ];
+        stream.read_exact(&mut buffer)?;
 
-        for _ in 0..count {
+        self.decode_nodes(storage, &buffer)?;
+
+        let result = read_u64(stream)?;
+        self.node_from_index(storage, result)
+    }
+
+    /// Decodes the given node array and inserts the nodes into the storage.
+    fn decode_nodes(&mut self, storage: &mut Storage, buffer: &[u8]) -> Result<(), MercError> {
+        storage.reserve(buffer.len() / 16);
+        self.nodes.reserve(buffer.len() / 16);
+
+        for node in buffer.chunks_exact(16) {
             // Read a single MDD node. It has the following structure: u64 | u64
             // RmRR RRRR RRRR VVVV | VVVV DcDD DDDD DDDD (little endian)
             // Every character is 4 bits, V = value, D = down, R = right, m = marked, c = copy.
-            let a = read_u64(stream)?;
-            let b = read_u64(stream)?;
-            //println!("{:064b} | {:064b}", a, b);
+            let a = u64::from_le_bytes(node[0..8].try_into().unwrap());
+            let b = u64::from_le_bytes(node[8..16].try_into().unwrap());
 
             let right = (a & 0x0000ffffffffffff) >> 1;
             let down = b >> 17;
+            let value = ((a >> 48) | ((b & 0xffff) << 16)) as u32;
 
-            let mut bytes: [u8; 4] = Default::default();
-            bytes[0..2].copy_from_slice(&a.to_le_bytes()[6..8]);
-            bytes[2..4].copy_from_slice(&b.to_le_bytes()[0..2]);
-            let value = u32::from_le_bytes(bytes);
-
-            let copy = right & 0x10000;
-            if copy != 0 {
-                panic!("We do not yet deal with copy nodes.");
-            }
-
-            let down = self.node_from_index(storage, down);
-            let right = self.node_from_index(storage, right);
+            // Copy nodes, which occur in transition relations, are decoded as
+            // ordinary nodes since [crate::relational_product] matches on the
+            // stored value and has no special treatment for them.
+            let down = self.node_from_index(storage, down)?;
+            let right = self.node_from_index(storage, right)?;
 
             let ldd = storage.insert(value as Value, &down, &right);
-            self.indexed_set.insert(self.last_index, ldd);
-
-            self.last_index += 1;
+            self.nodes.push(ldd);
         }
 
-        let result = read_u64(stream)?;
-        Ok(self.node_from_index(storage, result))
+        Ok(())
     }
 
     /// Returns the LDD belonging to the given index.
-    fn node_from_index(&self, storage: &mut Storage, index: u64) -> Ldd {
+    fn node_from_index(&self, storage: &mut Storage, index: u64) -> Result<Ldd, MercError> {
         if index == 0 {
-            storage.empty_set().clone()
+            Ok(storage.empty_set().clone())
         } else if index == 1 {
-            storage.empty_vector().clone()
+            Ok(storage.empty_vector().clone())
         } else {
-            self.indexed_set.get(&index).unwrap().clone()
+            Ok(self
+                .nodes
+                .get(index as usize - 2)
+                .ok_or(format!(
+                    "Read invalid ldd index {index}, length {}",
+                    self.nodes.len() + 2
+                ))?
+                .clone())
         }
     }
 }
@@ -78,6 +107,71 @@ impl Default for SylvanReader {
     }
 }
 
+/// A writer for LDDs in the Sylvan .ldd format, the counterpart of [SylvanReader].
+pub struct SylvanWriter {
+    nodes: RefCell<IndexedSet<Ldd>>, // Assigns indices to every written LDD.
+}
+
+impl SylvanWriter {
+    pub fn new(storage: &mut Storage) -> Self {
+        // The empty set and empty vector take the reserved indices 0 and 1.
+        let mut nodes = IndexedSet::new();
+        nodes.insert(storage.empty_set().clone());
+        nodes.insert(storage.empty_vector().clone());
+
+        Self {
+            nodes: RefCell::new(nodes),
+        }
+    }
+
+    /// Writes an LDD to the given stream in the Sylvan format.
+    pub fn write_ldd(&mut self, storage: &Storage, stream: &mut impl Write, ldd: &Ldd) -> Result<(), MercError> {
+        // The empty set and empty vector have reserved indices and cannot be traversed.
+        if ldd == storage.empty_set() || ldd == storage.empty_vector() {
+            write_u64(stream, 0)?;
+            return write_u64(stream, if ldd == storage.empty_set() { 0 } else { 1 });
+        }
+
+        // Encode the nodes that have not been written before in bottom-up
+        // order, since the node count precedes the node array in the stream.
+        let mut buffer: Vec<u8> = Vec::new();
+        for (node, Data(value, down, right)) in iter_nodes(storage, ldd, |node| {
+            // Skip any LDD that we have already inserted in the stream
+            !self.nodes.borrow().contains(node)
+        }) {
+            let mut nodes = self.nodes.borrow_mut();
+            let (_, inserted) = nodes.insert(node.clone());
+            if inserted {
+                let down = *nodes
+                    .index(&down)
+                    .expect("The down node must have already been written") as u64;
+                let right = *nodes
+                    .index(&right)
+                    .expect("The right node must have already been written") as u64;
+                debug_assert!(right < 1 << 47, "right index exceeds the 47 bits of the node layout.");
+                debug_assert!(down < 1 << 47, "down index exceeds the 47 bits of the node layout.");
+
+                // The inverse of the layout in [SylvanReader::decode_nodes],
+                // with the marked and copy bits zero.
+                let a = (right << 1) | ((value as u64 & 0xffff) << 48);
+                let b = (value as u64 >> 16) | (down << 17);
+                buffer.extend_from_slice(&a.to_le_bytes());
+                buffer.extend_from_slice(&b.to_le_bytes());
+            }
+        }
+
+        write_u64(stream, (buffer.len() / 16) as u64)?;
+        stream.write_all(&buffer)?;
+
+        let root = *self
+            .nodes
+            .borrow()
+            .index(ldd)
+            .expect("The root node has just been written") as u64;
+        write_u64(stream, root)
+    }
+}
+
 /// Returns a single u32 read from the given stream.
 pub fn read_u32(stream: &mut impl Read) -> Result<u32, MercError> {
     let mut buffer: [u8; 4] = Default::default();
@@ -93,3 +187,56 @@ pub fn read_u64(stream: &mut impl Read) -> Result<u64, MercError> {
 
     Ok(u64::from_le_bytes(buffer))
 }
+
+/// Writes a single u32 to the given stream.
+pub fn write_u32(stream: &mut impl Write, value: u32) -> Result<(), MercError> {
+    stream.write_all(&value.to_le_bytes())?;
+    Ok(())
+}
+
+/// Writes a single u64 to the given stream.
+pub fn write_u64(stream: &mut impl Write, value: u64) -> Result<(), MercError> {
+    stream.write_all(&value.to_le_bytes())?;
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use merc_utilities::random_test;
+
+    use crate::test_utility::from_iter;
+    use crate::test_utility::random_vector_set;
+
+    use super::*;
+
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_sylvan_ldd_stream() {
+        random_test(100, |rng| {
+            let mut storage = Storage::new();
+
+            let input: Vec<_> = (0..20)
+                .map(|_| {
+                    let input = random_vector_set(rng, 32, 10, 10);
+                    from_iter(&mut storage, input.iter())
+                })
+                .collect();
+
+            let mut vector: Vec<u8> = Vec::new();
+            let mut writer = SylvanWriter::new(&mut storage);
+            for term in &input {
+                writer.write_ldd(&storage, &mut vector, term).unwrap();
+            }
+
+            let mut reader = SylvanReader::new();
+            let mut stream = &vector[..];
+            for term in &input {
+                assert_eq!(
+                    *term,
+                    reader.read_ldd(&mut storage, &mut stream).unwrap(),
+                    "The read LDD must match the LDD that we have written"
+                );
+            }
+        });
+    }
+}
@@ -7,15 +7,19 @@ use ldd::LddIndex;
 use ldd::SharedProtectionSet;
 use merc_collections::IndexedSet;
 use merc_collections::ProtectionSet;
+use merc_utilities::count;
+use merc_utilities::start_timer;
 
 use crate::operations::height;
 
 mod cache;
 mod ldd;
+mod shared;
 
 pub use self::cache::*;
 pub use self::ldd::Ldd;
 pub use self::ldd::LddRef;
+pub use self::shared::*;
 
 pub type Value = u32;
 
@@ -81,6 +85,7 @@ pub struct Storage {
     cache: OperationCache,
 
     count_until_collection: u64,     // Count down until the next garbage collection.
+    number_of_collections: usize,    // The number of garbage collections performed so far.
     enable_garbage_collection: bool, // Whether to enable automatic garbage collection based on heuristics.
     enable_performance_metrics: bool,
     empty_set: Ldd,
@@ -107,6 +112,7 @@ impl Storage {
             cache: OperationCache::new(Rc::clone(&shared)),
 
             count_until_collection: 10000,
+            number_of_collections: 0,
             enable_garbage_collection: true,
             enable_performance_metrics: false,
             empty_set: Ldd::new(&shared, empty_set),
@@ -119,6 +125,12 @@ impl Storage {
         &mut self.cache
     }
 
+    /// Reserves capacity for at least `additional` more nodes in the node
+    /// table, avoiding repeated rehashing when loading large LDDs.
+    pub fn reserve(&mut self, additional: usize) {
+        self.nodes.reserve(additional);
+    }
+
     /// Create a new LDD node(value, down, right)
     pub fn insert(&mut self, value: Value, down: &LddRef, right: &LddRef) -> Ldd {
         // These invariants ensure that the result is a valid LDD.
@@ -157,10 +169,10 @@ impl Storage {
 
     /// Cleans up all LDDs that are unreachable from the root LDDs.
     pub fn garbage_collect(&mut self) {
-        // Clear the cache since it contains unprotected LDDs, and keep track of size before clearing.
+        count("ldd.collections", 1);
+        let _timer = start_timer("ldd.collection");
+
         let size_of_cache = self.cache.len();
-        self.cache.clear();
-        self.cache.limit(self.nodes.len());
 
         // Mark all nodes that are (indirect) children of nodes with positive reference count.
         let mut stack: Vec<LddIndex> = Vec::new();
@@ -168,6 +180,12 @@ impl Storage {
             mark_node(&mut self.nodes, &mut stack, *index);
         }
 
+        // Keep the cache entries whose nodes are all marked; these remain valid
+        // after collection since the node indices are stable. This avoids
+        // recomputing the same subproblems directly after every collection.
+        let nodes = &self.nodes;
+        self.cache.retain(|index| nodes[index].marked);
+
         // Collect all garbage nodes.
         let mut number_of_collections: usize = 0;
         self.nodes.retain_mut(|_, node| {
@@ -194,6 +212,10 @@ impl Storage {
             );
         }
 
+        // Grow the operation caches with the node table.
+        self.cache.resize(self.nodes.len());
+        self.number_of_collections += 1;
+
         if self.enable_performance_metrics {
             println!(
                 "Collected {number_of_collections} elements and {} elements remaining",
@@ -212,6 +234,21 @@ impl Storage {
         self.enable_performance_metrics = enabled;
     }
 
+    /// Returns the number of nodes currently in the node table.
+    pub fn num_of_nodes(&self) -> usize {
+        self.nodes.len()
+    }
+
+    /// Returns the peak number of nodes that were in the node table.
+    pub fn peak_num_of_nodes(&self) -> usize {
+        self.nodes.capacity()
+    }
+
+    /// Returns the number of garbage collections performed so far.
+    pub fn num_of_garbage_collections(&self) -> usize {
+        self.number_of_collections
+    }
+
     /// The 'false' LDD.
     pub fn empty_set(&self) -> &Ldd {
         &self.empty_set
@@ -285,6 +322,7 @@ impl Drop for Storage {
                 self.protection_set.borrow().maximum_size()
             );
             println!("There were at most {} nodes.", self.nodes.capacity());
+            self.cache.print_metrics();
         }
     }
 }
@@ -91,6 +91,80 @@ impl OperationCache {
         }
     }
 
+    /// Grows the operation caches to match the given node table size, keeping
+    /// the existing entries.
+    pub fn resize(&mut self, size: usize) {
+        for cache in self.caches1.iter_mut() {
+            cache.resize(size / 4);
+        }
+
+        for cache in self.caches2.iter_mut() {
+            cache.resize(size / 4);
+        }
+
+        for cache in self.caches3.iter_mut() {
+            cache.resize(size / 4);
+        }
+    }
+
+    /// Keeps only the entries for which all indices satisfy the given
+    /// predicate. Used during garbage collection to keep the entries whose
+    /// nodes are all marked, instead of clearing the caches wholesale.
+    pub fn retain<F>(&mut self, marked: F)
+    where
+        F: Fn(LddIndex) -> bool,
+    {
+        for cache in self.caches1.iter_mut() {
+            cache.retain(|key, _| marked(*key));
+        }
+
+        for cache in self.caches2.iter_mut() {
+            cache.retain(|key, value| marked(key.0) && marked(key.1) && marked(*value));
+        }
+
+        for cache in self.caches3.iter_mut() {
+            cache.retain(|key, value| marked(key.0) && marked(key.1) && marked(key.2) && marked(*value));
+        }
+    }
+
+    /// Returns the number of cache hits, misses and evictions aggregated over
+    /// all operation caches.
+    pub fn metrics(&self) -> (u64, u64, u64) {
+        let mut result = (0, 0, 0);
+        let mut add = |(hits, misses, evictions): (u64, u64, u64)| {
+            result.0 += hits;
+            result.1 += misses;
+            result.2 += evictions;
+        };
+
+        for cache in self.caches1.iter() {
+            add(cache.metrics());
+        }
+
+        for cache in self.caches2.iter() {
+            add(cache.metrics());
+        }
+
+        for cache in self.caches3.iter() {
+            add(cache.metrics());
+        }
+
+        result
+    }
+
+    /// Prints the hits, misses and evictions of every operation cache.
+    pub fn print_metrics(&self) {
+        let print = |name: &str, (hits, misses, evictions): (u64, u64, u64)| {
+            println!("Cache {name}: {hits} hits, {misses} misses, {evictions} evictions");
+        };
+
+        print("len", self.caches1[0].metrics());
+        print("union", self.caches2[0].metrics());
+        print("merge", self.caches2[1].metrics());
+        print("minus", self.caches2[2].metrics());
+        print("relational_product", self.caches3[0].metrics());
+    }
+
     fn get_cache1(&mut self, operator: &UnaryFunction) -> &mut Cache<LddIndex, usize> {
         match operator {
             UnaryFunction::Len => &mut self.caches1[0],
@@ -121,9 +195,16 @@ impl OperationCache {
 /// on the maximum amount of elements stored. The cache requires that default
 /// values of K are never used in calls to get and insert, because these are
 /// used to indicate empty cache entries.
+///
+/// Keeps track of the number of hits, misses and evictions to provide insight
+/// into the effectiveness of the cache.
 pub struct Cache<K, V, S = RandomState> {
     table: Vec<(K, V)>,
     hash_builder: S,
+
+    hits: u64,
+    misses: u64,
+    evictions: u64,
 }
 
 impl<K: Default + Clone, V: Clone + Default> Cache<K, V, RandomState> {
@@ -131,6 +212,9 @@ impl<K: Default + Clone, V: Clone + Default> Cache<K, V, RandomState> {
         Cache {
             table: vec![Default::default(); 1024],
             hash_builder: RandomState::default(),
+            hits: 0,
+            misses: 0,
+            evictions: 0,
         }
     }
 }
@@ -167,6 +251,26 @@ impl<K: Default + Clone, V: Clone + Default, S> Cache<K, V, S> {
     pub fn is_empty(&self) -> bool {
         self.len() == 0
     }
+
+    /// Returns the number of cache hits, misses and evictions respectively.
+    /// These counters are kept across clear and resize calls.
+    pub fn metrics(&self) -> (u64, u64, u64) {
+        (self.hits, self.misses, self.evictions)
+    }
+
+    /// Keeps only the entries for which the given predicate holds, the other
+    /// entries are removed from the cache.
+    pub fn retain<F>(&mut self, mut f: F)
+    where
+        K: Eq,
+        F: FnMut(&K, &V) -> bool,
+    {
+        for entry in self.table.iter_mut() {
+            if entry.0 != K::default() && !f(&entry.0, &entry.1) {
+                *entry = Default::default();
+            }
+        }
+    }
 }
 
 impl<K: Default + Eq + Hash, V, S: BuildHasher> Cache<K, V, S> {
@@ -178,7 +282,13 @@ impl<K: Default + Eq + Hash, V, S: BuildHasher> Cache<K, V, S> {
         let index = self.hash_builder.hash_one(key) % (self.table.len() as u64);
 
         let entry = &self.table[index as usize];
-        if entry.0 == *key { Some(&entry.1) } else { None }
+        if entry.0 == *key {
+            self.hits += 1;
+            Some(&self.table[index as usize].1)
+        } else {
+            self.misses += 1;
+            None
+        }
     }
 
     /// Inserts the given key value pair into the cache. Might evict other pairs in the cache.
@@ -186,9 +296,34 @@ impl<K: Default + Eq + Hash, V, S: BuildHasher> Cache<K, V, S> {
         debug_assert!(key != K::default(), "The key may never be equal to its default value.");
 
         // Compute the index in the table.
-
         let index = self.hash_builder.hash_one(&key) % (self.table.len() as u64);
-        self.table[index as usize] = (key, value);
+
+        let entry = &mut self.table[index as usize];
+        if entry.0 != K::default() && entry.0 != key {
+            self.evictions += 1;
+        }
+
+        *entry = (key, value);
+    }
+}
+
+impl<K: Default + Clone + Eq + Hash, V: Clone + Default, S: BuildHasher> Cache<K, V, S> {
+    /// Grows the table to hold at least the given number of entries, keeping
+    /// the existing entries. Unlike [Cache::limit] the table never shrinks, so
+    /// the cache grows adaptively with the size of the node table.
+    pub fn resize(&mut self, size: usize) {
+        let power_of_two = size.next_power_of_two();
+        if power_of_two <= self.table.len() {
+            return;
+        }
+
+        let table = std::mem::replace(&mut self.table, vec![Default::default(); power_of_two]);
+        for entry in table {
+            if entry.0 != K::default() {
+                let index = self.hash_builder.hash_one(&entry.0) % (self.table.len() as u64);
+                self.table[index as usize] = entry;
+            }
+        }
     }
 }
 
@@ -197,6 +332,9 @@ impl<K: Clone, V: Clone, S: Clone> Clone for Cache<K, V, S> {
         Cache {
             table: self.table.clone(),
             hash_builder: self.hash_builder.clone(),
+            hits: self.hits,
+            misses: self.misses,
+            evictions: self.evictions,
         }
     }
 }
@@ -291,3 +429,47 @@ where
         result
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_cache_resize_keeps_entries() {
+        let mut cache: Cache<usize, usize> = Cache::new();
+
+        for key in 1..100 {
+            cache.insert(key, key * 2);
+        }
+
+        cache.resize(4096);
+
+        let mut found = 0;
+        for key in 1..100 {
+            if let Some(value) = cache.get(&key) {
+                assert_eq!(*value, key * 2, "The value should be unchanged after resizing");
+                found += 1;
+            }
+        }
+
+        assert!(found > 0, "At least some entries should survive resizing");
+    }
+
+    #[test]
+    fn test_cache_retain_and_metrics() {
+        let mut cache: Cache<usize, usize> = Cache::new();
+
+        cache.insert(1, 2);
+        cache.insert(3, 4);
+
+        // Keep only the entry with an even value.
+        cache.retain(|_, value| value % 2 == 0);
+
+        assert_eq!(cache.get(&1), Some(&2).copied().as_ref());
+        assert_eq!(cache.get(&3), Some(&4).copied().as_ref());
+
+        let (hits, misses, _) = cache.metrics();
+        assert_eq!(hits, 2);
+        assert_eq!(misses, 0);
+    }
+}
@@ -0,0 +1,839 @@
+use std::cmp::Ordering;
+use std::collections::HashSet;
+use std::fmt;
+use std::fmt::Debug;
+use std::fmt::Formatter;
+use std::hash::Hash;
+use std::hash::Hasher;
+use std::ptr::NonNull;
+use std::sync::Arc;
+use std::sync::Mutex;
+use std::sync::atomic::AtomicU64;
+use std::sync::atomic::Ordering as MemoryOrdering;
+
+use merc_collections::ProtectionIndex;
+use merc_collections::ProtectionSet;
+use merc_unsafety::StablePointerSet;
+
+use crate::Cache;
+use crate::Value;
+
+/// An LDD node(value, down, right) in the concurrent unique table, where the
+/// children are stable pointers into the same table.
+#[derive(Clone)]
+pub struct SharedNode {
+    value: Value,
+    down: NonNull<SharedNode>,
+    right: NonNull<SharedNode>,
+}
+
+impl PartialEq for SharedNode {
+    fn eq(&self, other: &Self) -> bool {
+        self.value == other.value && self.down == other.down && self.right == other.right
+    }
+}
+
+impl Eq for SharedNode {}
+
+impl Hash for SharedNode {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        self.value.hash(state);
+        self.down.hash(state);
+        self.right.hash(state);
+    }
+}
+
+impl From<&SharedNode> for SharedNode {
+    fn from(node: &SharedNode) -> Self {
+        node.clone()
+    }
+}
+
+// SAFETY: The children are owned by the unique table and never mutated after creation.
+unsafe impl Send for SharedNode {}
+unsafe impl Sync for SharedNode {}
+
+/// The protection set of a single [ThreadStorage], shared with the storage for
+/// the purpose of garbage collection.
+type SharedProtectionSetSync = Arc<Mutex<ProtectionSet<NonNull<SharedNode>>>>;
+
+/// The state shared between all threads.
+struct Shared {
+    /// The concurrent unique table, cf. the shared term table in `merc_aterm`.
+    nodes: StablePointerSet<SharedNode>,
+
+    /// The protection sets of all registered [ThreadStorage] instances.
+    protection_sets: Mutex<Vec<SharedProtectionSetSync>>,
+
+    /// Incremented on every garbage collection so that thread storages can
+    /// invalidate their operation caches lazily.
+    generation: AtomicU64,
+
+    empty_set: NonNull<SharedNode>,
+    empty_vector: NonNull<SharedNode>,
+}
+
+// SAFETY: All mutable state is behind the concurrent unique table, mutexes or atomics.
+unsafe impl Send for Shared {}
+unsafe impl Sync for Shared {}
+
+/// A concurrent LDD storage that allows multiple threads to create and cache
+/// nodes simultaneously, in the same way as the shared term pool in
+/// `merc_aterm`. The unique table is a sharded concurrent hash set and every
+/// thread obtains a [ThreadStorage] with its own operation caches and
+/// protection set through [SharedStorage::local].
+///
+/// Unlike [crate::Storage] garbage collection is not automatic; it must be
+/// triggered explicitly through [SharedStorage::garbage_collect] at a moment
+/// where no thread is performing operations.
+#[derive(Clone)]
+pub struct SharedStorage {
+    shared: Arc<Shared>,
+}
+
+impl Default for SharedStorage {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl SharedStorage {
+    pub fn new() -> Self {
+        let nodes: StablePointerSet<SharedNode> = StablePointerSet::new();
+
+        // Add two nodes representing 'false' and 'true' respectively; these cannot be created using insert.
+        // Their children are dangling and are never dereferenced.
+        let (empty_set, _) = nodes.insert_equiv(&SharedNode {
+            value: 0,
+            down: NonNull::dangling(),
+            right: NonNull::dangling(),
+        });
+        let (empty_vector, _) = nodes.insert_equiv(&SharedNode {
+            value: 1,
+            down: NonNull::dangling(),
+            right: NonNull::dangling(),
+        });
+
+        Self {
+            shared: Arc::new(Shared {
+                empty_set: empty_set.ptr(),
+                empty_vector: empty_vector.ptr(),
+                nodes,
+                protection_sets: Mutex::new(Vec::new()),
+                generation: AtomicU64::new(0),
+            }),
+        }
+    }
+
+    /// Creates a thread local view of this storage with its own operation caches.
+    pub fn local(&self) -> ThreadStorage {
+        let protection_set: SharedProtectionSetSync = Arc::new(Mutex::new(ProtectionSet::new()));
+        self.shared
+            .protection_sets
+            .lock()
+            .expect("Lock poisoned!")
+            .push(Arc::clone(&protection_set));
+
+        let empty_set = SharedLdd::new(&protection_set, self.shared.empty_set);
+        let empty_vector = SharedLdd::new(&protection_set, self.shared.empty_vector);
+
+        ThreadStorage {
+            shared: Arc::clone(&self.shared),
+            protection_set,
+            generation: self.shared.generation.load(MemoryOrdering::SeqCst),
+            caches1: vec![Cache::new()],
+            caches2: vec![Cache::new(); 2],
+            caches3: vec![Cache::new()],
+            empty_set,
+            empty_vector,
+        }
+    }
+
+    /// Returns the number of nodes in the unique table.
+    pub fn len(&self) -> usize {
+        self.shared.nodes.len()
+    }
+
+    /// Returns true iff the unique table only contains the constants.
+    pub fn is_empty(&self) -> bool {
+        self.shared.nodes.len() <= 2
+    }
+
+    /// Cleans up all LDDs that are unreachable from the root LDDs.
+    ///
+    /// This is a stop-the-world collection: the caller must ensure that no
+    /// thread performs operations on any [ThreadStorage] while this function
+    /// runs. Thread storages detect the collection afterwards and clear their
+    /// operation caches before their next operation.
+    pub fn garbage_collect(&self) {
+        let protection_sets = self.shared.protection_sets.lock().expect("Lock poisoned!");
+
+        // Mark all nodes that are (indirect) children of protected nodes.
+        let mut marked: HashSet<NonNull<SharedNode>> = HashSet::new();
+        marked.insert(self.shared.empty_set);
+        marked.insert(self.shared.empty_vector);
+
+        let mut stack: Vec<NonNull<SharedNode>> = Vec::new();
+        for protection_set in protection_sets.iter() {
+            let protection_set = protection_set.lock().expect("Lock poisoned!");
+            for (_root, node) in protection_set.iter() {
+                stack.push(*node);
+            }
+
+            while let Some(current) = stack.pop() {
+                if marked.insert(current) {
+                    // SAFETY: The node is protected or reachable from a protected node, so it is in the table.
+                    let node = unsafe { current.as_ref() };
+                    stack.push(node.down);
+                    stack.push(node.right);
+                }
+            }
+        }
+
+        self.shared.nodes.retain(|pointer| marked.contains(&pointer.ptr()));
+        self.shared.generation.fetch_add(1, MemoryOrdering::SeqCst);
+    }
+}
+
+/// Every SharedLdd points to its root node in the [SharedStorage] unique
+/// table, protected through the protection set of the [ThreadStorage] that
+/// created it. Instances can be sent to other threads.
+pub struct SharedLdd {
+    node: NonNull<SharedNode>,
+    root: ProtectionIndex,
+    protection_set: SharedProtectionSetSync,
+}
+
+impl SharedLdd {
+    /// Creates a new SharedLdd instance. This should only be called from the storage.
+    fn new(protection_set: &SharedProtectionSetSync, node: NonNull<SharedNode>) -> SharedLdd {
+        let root = protection_set.lock().expect("Lock poisoned!").protect(node);
+        SharedLdd {
+            node,
+            root,
+            protection_set: Arc::clone(protection_set),
+        }
+    }
+}
+
+// SAFETY: The underlying node is owned by the unique table and the protection set is behind a mutex.
+unsafe impl Send for SharedLdd {}
+unsafe impl Sync for SharedLdd {}
+
+impl Clone for SharedLdd {
+    fn clone(&self) -> Self {
+        SharedLdd::new(&self.protection_set, self.node)
+    }
+}
+
+impl Drop for SharedLdd {
+    fn drop(&mut self) {
+        self.protection_set.lock().expect("Lock poisoned!").unprotect(self.root);
+    }
+}
+
+impl PartialEq for SharedLdd {
+    fn eq(&self, other: &Self) -> bool {
+        self.node == other.node
+    }
+}
+
+impl Eq for SharedLdd {}
+
+impl Hash for SharedLdd {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        self.node.hash(state);
+    }
+}
+
+impl Debug for SharedLdd {
+    fn fmt(&self, f: &mut Formatter<'_>) -> fmt::Result {
+        write!(f, "node: {:?}", self.node)
+    }
+}
+
+/// A thread local view of a [SharedStorage] with its own operation caches, cf.
+/// the thread term pool in `merc_aterm`. Node creation goes directly into the
+/// concurrent unique table, so thread storages of different threads can be
+/// used simultaneously.
+pub struct ThreadStorage {
+    shared: Arc<Shared>,
+    protection_set: SharedProtectionSetSync,
+
+    /// The generation of the shared storage for which the caches are valid.
+    generation: u64,
+
+    caches1: Vec<Cache<usize, usize>>,
+    caches2: Vec<Cache<(usize, usize), usize>>,
+    caches3: Vec<Cache<(usize, usize, usize), usize>>,
+
+    empty_set: SharedLdd,
+    empty_vector: SharedLdd,
+}
+
+/// Index of the union cache in [ThreadStorage::caches2].
+const CACHE_UNION: usize = 0;
+/// Index of the minus cache in [ThreadStorage::caches2].
+const CACHE_MINUS: usize = 1;
+
+impl ThreadStorage {
+    /// The 'false' LDD.
+    pub fn empty_set(&self) -> &SharedLdd {
+        &self.empty_set
+    }
+
+    /// The 'true' LDD.
+    pub fn empty_vector(&self) -> &SharedLdd {
+        &self.empty_vector
+    }
+
+    /// Create a new LDD node(value, down, right)
+    pub fn insert(&mut self, value: Value, down: &SharedLdd, right: &SharedLdd) -> SharedLdd {
+        let result = self.insert_node(value, down.node, right.node);
+        self.protect(result)
+    }
+
+    /// The value of an LDD node(value, down, right). Note, ldd cannot be 'true' or 'false.
+    pub fn value(&self, ldd: &SharedLdd) -> Value {
+        self.get(ldd.node).0
+    }
+
+    /// The down of an LDD node(value, down, right). Note, ldd cannot be 'true' or 'false.
+    pub fn down(&self, ldd: &SharedLdd) -> SharedLdd {
+        let down = self.get(ldd.node).1;
+        self.protect(down)
+    }
+
+    /// The right of an LDD node(value, down, right). Note, ldd cannot be 'true' or 'false.
+    pub fn right(&self, ldd: &SharedLdd) -> SharedLdd {
+        let right = self.get(ldd.node).2;
+        self.protect(right)
+    }
+
+    /// Returns an LDD containing only the given vector, i.e., { vector }.
+    pub fn singleton(&mut self, vector: &[Value]) -> SharedLdd {
+        let mut root = self.shared.empty_vector;
+        for value in vector.iter().rev() {
+            root = self.insert_node(*value, root, self.shared.empty_set);
+        }
+
+        self.protect(root)
+    }
+
+    /// Computes a meta LDD from the given read and write projections that is
+    /// suitable for [ThreadStorage::relational_product], cf.
+    /// [crate::compute_meta].
+    pub fn compute_meta(&mut self, read_proj: &[Value], write_proj: &[Value]) -> SharedLdd {
+        let length = std::cmp::max(
+            read_proj.iter().max().map_or(0, |x| *x + 1),
+            write_proj.iter().max().map_or(0, |x| *x + 1),
+        );
+
+        let mut meta: Vec<Value> = Vec::new();
+        for i in 0..length {
+            let read = read_proj.contains(&i);
+            let write = write_proj.contains(&i);
+
+            if read && write {
+                meta.push(3);
+                meta.push(4);
+            } else if read {
+                meta.push(1);
+            } else if write {
+                meta.push(2);
+            } else {
+                meta.push(0);
+            }
+        }
+
+        self.singleton(&meta)
+    }
+
+    /// Returns the union of the given LDDs, i.e., a ∪ b.
+    pub fn union(&mut self, a: &SharedLdd, b: &SharedLdd) -> SharedLdd {
+        self.refresh_caches();
+        let result = self.union_impl(a.node, b.node);
+        self.protect(result)
+    }
+
+    /// Returns the largest subset of 'a' that does not contains elements of 'b', i.e., set difference.
+    pub fn minus(&mut self, a: &SharedLdd, b: &SharedLdd) -> SharedLdd {
+        self.refresh_caches();
+        let result = self.minus_impl(a.node, b.node);
+        self.protect(result)
+    }
+
+    /// Computes the set of vectors reachable in one step from the given set as
+    /// defined by the sparse relation rel, cf. [crate::relational_product].
+    pub fn relational_product(&mut self, set: &SharedLdd, rel: &SharedLdd, meta: &SharedLdd) -> SharedLdd {
+        self.refresh_caches();
+        let result = self.relational_product_impl(set.node, rel.node, meta.node);
+        self.protect(result)
+    }
+
+    /// Returns the number of elements in the set.
+    pub fn len(&mut self, set: &SharedLdd) -> usize {
+        self.refresh_caches();
+        self.len_impl(set.node)
+    }
+
+    /// Returns the height of the LDD tree.
+    pub fn height(&self, ldd: &SharedLdd) -> usize {
+        self.height_impl(ldd.node)
+    }
+
+    /// Upgrade a node pointer to a protected [SharedLdd] instance.
+    fn protect(&self, node: NonNull<SharedNode>) -> SharedLdd {
+        SharedLdd::new(&self.protection_set, node)
+    }
+
+    /// Returns the (value, down, right) of the given node. Note, the node cannot be 'true' or 'false'.
+    fn get(&self, node: NonNull<SharedNode>) -> (Value, NonNull<SharedNode>, NonNull<SharedNode>) {
+        debug_assert_ne!(node, self.shared.empty_set, "Cannot inspect empty set.");
+        debug_assert_ne!(node, self.shared.empty_vector, "Cannot inspect empty vector.");
+
+        // SAFETY: The node is protected (indirectly) by the caller and nodes are never mutated.
+        let node = unsafe { node.as_ref() };
+        (node.value, node.down, node.right)
+    }
+
+    /// Create a new node(value, down, right) in the concurrent unique table.
+    fn insert_node(
+        &self,
+        value: Value,
+        down: NonNull<SharedNode>,
+        right: NonNull<SharedNode>,
+    ) -> NonNull<SharedNode> {
+        // These invariants ensure that the result is a valid LDD.
+        debug_assert_ne!(down, self.shared.empty_set, "down node can never be the empty set.");
+        debug_assert_ne!(
+            right, self.shared.empty_vector,
+            "right node can never be the empty vector."
+        );
+
+        if right != self.shared.empty_set {
+            debug_assert_eq!(
+                self.height_impl(down) + 1,
+                self.height_impl(right),
+                "height of the down node should match the right node height."
+            );
+            debug_assert!(
+                value < self.get(right).0,
+                "value should be less than right node value."
+            );
+        }
+
+        let (pointer, _inserted) = self.shared.nodes.insert_equiv(&SharedNode { value, down, right });
+        pointer.ptr()
+    }
+
+    /// Clears the operation caches when a garbage collection has taken place
+    /// since they contain unprotected nodes.
+    fn refresh_caches(&mut self) {
+        let generation = self.shared.generation.load(MemoryOrdering::SeqCst);
+        if generation != self.generation {
+            for cache in self.caches1.iter_mut() {
+                cache.clear();
+            }
+            for cache in self.caches2.iter_mut() {
+                cache.clear();
+            }
+            for cache in self.caches3.iter_mut() {
+                cache.clear();
+            }
+
+            self.generation = generation;
+        }
+    }
+
+    fn height_impl(&self, node: NonNull<SharedNode>) -> usize {
+        if node == self.shared.empty_set || node == self.shared.empty_vector {
+            0
+        } else {
+            // Since all children have the same height we only have to look at the down node.
+            self.height_impl(self.get(node).1) + 1
+        }
+    }
+
+    fn union_impl(&mut self, a: NonNull<SharedNode>, b: NonNull<SharedNode>) -> NonNull<SharedNode> {
+        if a == b {
+            return a;
+        } else if a == self.shared.empty_set {
+            return b;
+        } else if b == self.shared.empty_set {
+            return a;
+        }
+
+        // Reorder the inputs to improve caching behaviour (can potentially half the cache size)
+        let (a, b) = if a < b { (a, b) } else { (b, a) };
+
+        let key = (addr(a), addr(b));
+        if let Some(result) = self.caches2[CACHE_UNION].get(&key) {
+            return node_from_addr(*result);
+        }
+
+        let (a_value, a_down, a_right) = self.get(a);
+        let (b_value, b_down, b_right) = self.get(b);
+
+        let result = match a_value.cmp(&b_value) {
+            Ordering::Less => {
+                let result = self.union_impl(a_right, b);
+                self.insert_node(a_value, a_down, result)
+            }
+            Ordering::Equal => {
+                let down_result = self.union_impl(a_down, b_down);
+                let right_result = self.union_impl(a_right, b_right);
+                self.insert_node(a_value, down_result, right_result)
+            }
+            Ordering::Greater => {
+                let result = self.union_impl(a, b_right);
+                self.insert_node(b_value, b_down, result)
+            }
+        };
+
+        self.caches2[CACHE_UNION].insert(key, addr(result));
+        result
+    }
+
+    fn minus_impl(&mut self, a: NonNull<SharedNode>, b: NonNull<SharedNode>) -> NonNull<SharedNode> {
+        if a == b || a == self.shared.empty_set {
+            return self.shared.empty_set;
+        } else if b == self.shared.empty_set {
+            return a;
+        }
+
+        let key = (addr(a), addr(b));
+        if let Some(result) = self.caches2[CACHE_MINUS].get(&key) {
+            return node_from_addr(*result);
+        }
+
+        let (a_value, a_down, a_right) = self.get(a);
+        let (b_value, b_down, b_right) = self.get(b);
+
+        let result = match a_value.cmp(&b_value) {
+            Ordering::Less => {
+                let right_result = self.minus_impl(a_right, b);
+                self.insert_node(a_value, a_down, right_result)
+            }
+            Ordering::Equal => {
+                let down_result = self.minus_impl(a_down, b_down);
+                let right_result = self.minus_impl(a_right, b_right);
+                if down_result == self.shared.empty_set {
+                    right_result
+                } else {
+                    self.insert_node(a_value, down_result, right_result)
+                }
+            }
+            Ordering::Greater => self.minus_impl(a, b_right),
+        };
+
+        self.caches2[CACHE_MINUS].insert(key, addr(result));
+        result
+    }
+
+    fn relational_product_impl(
+        &mut self,
+        set: NonNull<SharedNode>,
+        rel: NonNull<SharedNode>,
+        meta: NonNull<SharedNode>,
+    ) -> NonNull<SharedNode> {
+        debug_assert_ne!(meta, self.shared.empty_set, "meta must be a singleton");
+
+        if meta == self.shared.empty_vector {
+            // If meta is not defined then the rest is not in the relation (meta is always zero)
+            return set;
+        } else if set == self.shared.empty_set || rel == self.shared.empty_set {
+            return self.shared.empty_set;
+        }
+
+        let key = (addr(set), addr(rel), addr(meta));
+        if let Some(result) = self.caches3[0].get(&key) {
+            return node_from_addr(*result);
+        }
+
+        let (meta_value, meta_down, _) = self.get(meta);
+
+        let result = match meta_value {
+            0 => {
+                // Consider all values on this level part of the output and continue with rest.
+                let (value, down, right) = self.get(set);
+
+                let right_result = self.relational_product_impl(right, rel, meta);
+                let down_result = self.relational_product_impl(down, rel, meta_down);
+                if down_result == self.shared.empty_set {
+                    right_result
+                } else {
+                    self.insert_node(value, down_result, right_result)
+                }
+            }
+            1 => {
+                // Read the values present in the relation and continue with these values in the set.
+                let (set_value, set_down, set_right) = self.get(set);
+                let (rel_value, rel_down, rel_right) = self.get(rel);
+
+                match set_value.cmp(&rel_value) {
+                    Ordering::Less => self.relational_product_impl(set_right, rel, meta),
+                    Ordering::Equal => {
+                        let down_result = self.relational_product_impl(set_down, rel_down, meta_down);
+                        let right_result = self.relational_product_impl(set_right, rel_right, meta);
+                        if down_result == self.shared.empty_set {
+                            right_result
+                        } else {
+                            self.insert_node(set_value, down_result, right_result)
+                        }
+                    }
+                    Ordering::Greater => self.relational_product_impl(set, rel_right, meta),
+                }
+            }
+            2 => {
+                // All values in set should be considered.
+                let mut combined = self.shared.empty_set;
+                let mut current = set;
+                loop {
+                    let (_, set_down, set_right) = self.get(current);
+                    combined = self.union_impl(combined, set_down);
+
+                    if set_right == self.shared.empty_set {
+                        break;
+                    }
+                    current = set_right;
+                }
+
+                // Write the values present in the relation.
+                let (rel_value, rel_down, rel_right) = self.get(rel);
+
+                let down_result = self.relational_product_impl(combined, rel_down, meta_down);
+                let right_result = self.relational_product_impl(set, rel_right, meta);
+                if down_result == self.shared.empty_set {
+                    right_result
+                } else {
+                    self.insert_node(rel_value, down_result, right_result)
+                }
+            }
+            3 => {
+                let (set_value, set_down, set_right) = self.get(set);
+                let (rel_value, rel_down, rel_right) = self.get(rel);
+
+                match set_value.cmp(&rel_value) {
+                    Ordering::Less => self.relational_product_impl(set_right, rel, meta),
+                    Ordering::Equal => {
+                        let down_result = self.relational_product_impl(set_down, rel_down, meta_down);
+                        let right_result = self.relational_product_impl(set_right, rel_right, meta);
+                        self.union_impl(down_result, right_result)
+                    }
+                    Ordering::Greater => self.relational_product_impl(set, rel_right, meta),
+                }
+            }
+            4 => {
+                // Write the values present in the relation.
+                let (rel_value, rel_down, rel_right) = self.get(rel);
+
+                let down_result = self.relational_product_impl(set, rel_down, meta_down);
+                let right_result = self.relational_product_impl(set, rel_right, meta);
+                if down_result == self.shared.empty_set {
+                    right_result
+                } else {
+                    self.insert_node(rel_value, down_result, right_result)
+                }
+            }
+            x => {
+                panic!("meta has unexpected value: {x}");
+            }
+        };
+
+        self.caches3[0].insert(key, addr(result));
+        result
+    }
+
+    fn len_impl(&mut self, set: NonNull<SharedNode>) -> usize {
+        if set == self.shared.empty_set {
+            return 0;
+        } else if set == self.shared.empty_vector {
+            return 1;
+        }
+
+        let key = addr(set);
+        if let Some(result) = self.caches1[0].get(&key) {
+            return *result;
+        }
+
+        let mut result: usize = 0;
+        let mut current = set;
+        while current != self.shared.empty_set {
+            // Progress to the right LDD.
+            let (_, down, right) = self.get(current);
+            result += self.len_impl(down);
+            current = right;
+        }
+
+        self.caches1[0].insert(key, result);
+        result
+    }
+}
+
+impl Drop for ThreadStorage {
+    fn drop(&mut self) {
+        // Unregister the protection set of this thread storage.
+        self.shared
+            .protection_sets
+            .lock()
+            .expect("Lock poisoned!")
+            .retain(|protection_set| !Arc::ptr_eq(protection_set, &self.protection_set));
+    }
+}
+
+/// Returns the address of the given node, used as operation cache key since
+/// the address zero is never a valid node.
+fn addr(node: NonNull<SharedNode>) -> usize {
+    node.as_ptr() as usize
+}
+
+/// Inverse of [addr].
+fn node_from_addr(addr: usize) -> NonNull<SharedNode> {
+    NonNull::new(addr as *mut SharedNode).expect("The cache never contains null addresses")
+}
+
+#[cfg(test)]
+mod tests {
+    use std::collections::HashSet;
+
+    use super::*;
+    use crate::Storage;
+    use crate::singleton;
+    use crate::test_utility::*;
+
+    use merc_utilities::random_test;
+
+    /// Builds the LDD for the given set of vectors in the thread storage.
+    fn from_vectors(storage: &mut ThreadStorage, vectors: &HashSet<Vec<Value>>) -> SharedLdd {
+        let mut result = storage.empty_set().clone();
+        for vector in vectors {
+            let single = storage.singleton(vector);
+            result = storage.union(&result, &single);
+        }
+
+        result
+    }
+
+    #[test]
+    fn test_shared_storage_random_operations() {
+        random_test(100, |rng| {
+            let shared = SharedStorage::new();
+            let mut local = shared.local();
+            let mut storage = Storage::new();
+
+            // The shared storage operations must agree with the sequential storage.
+            let set_a = random_vector_set(rng, 32, 4, 10);
+            let set_b = random_vector_set(rng, 32, 4, 10);
+
+            let a = from_vectors(&mut local, &set_a);
+            let b = from_vectors(&mut local, &set_b);
+
+            let expected = from_iter(&mut storage, set_a.union(&set_b));
+            let result = local.union(&a, &b);
+
+            assert_eq!(
+                local.len(&result),
+                crate::len(&mut storage, &expected),
+                "The union in the shared storage should match the sequential result"
+            );
+        });
+    }
+
+    #[test]
+    fn test_shared_storage_concurrent_insert() {
+        let shared = SharedStorage::new();
+
+        let handles: Vec<_> = (0..4u32)
+            .map(|thread| {
+                let shared = shared.clone();
+                std::thread::spawn(move || {
+                    let mut local = shared.local();
+
+                    let mut result = local.empty_set().clone();
+                    for i in 0..64u32 {
+                        let single = local.singleton(&[thread, i, i % 7]);
+                        result = local.union(&result, &single);
+                    }
+
+                    assert_eq!(local.len(&result), 64, "Every thread inserts distinct vectors");
+                    result
+                })
+            })
+            .collect();
+
+        // Combine the results of all threads; the vectors of different threads are distinct.
+        let mut local = shared.local();
+        let mut result = local.empty_set().clone();
+        for handle in handles {
+            let set = handle.join().expect("Thread panicked");
+            result = local.union(&result, &set);
+        }
+
+        assert_eq!(local.len(&result), 4 * 64);
+    }
+
+    #[test]
+    fn test_shared_storage_garbage_collection() {
+        random_test(10, |rng| {
+            let shared = SharedStorage::new();
+            let mut local = shared.local();
+
+            let kept = {
+                let discarded = from_vectors(&mut local, &random_vector_set(rng, 64, 4, 10));
+                let kept = from_vectors(&mut local, &random_vector_set(rng, 64, 4, 10));
+                let length = local.len(&kept);
+                drop(discarded);
+                (kept, length)
+            };
+
+            shared.garbage_collect();
+
+            // The kept LDD must be unaffected by the collection.
+            assert_eq!(local.len(&kept.0), kept.1);
+        });
+    }
+
+    #[test]
+    fn test_shared_storage_matches_sequential_relational_product() {
+        random_test(10, |rng| {
+            let shared = SharedStorage::new();
+            let mut local = shared.local();
+            let mut storage = Storage::new();
+
+            let set = random_vector_set(rng, 32, 4, 10);
+            let relation = random_vector_set(rng, 32, 4, 10);
+            let read_proj = vec![0, 2];
+            let write_proj = vec![0, 2];
+
+            let local_set = from_vectors(&mut local, &set);
+            let local_rel = from_vectors(&mut local, &relation);
+            let local_meta = local.compute_meta(&read_proj, &write_proj);
+            let local_result = local.relational_product(&local_set, &local_rel, &local_meta);
+
+            let expected_set = from_iter(&mut storage, set.iter());
+            let expected_rel = from_iter(&mut storage, relation.iter());
+            let expected_meta = crate::compute_meta(&mut storage, &read_proj, &write_proj);
+            let expected = crate::relational_product(&mut storage, &expected_set, &expected_rel, &expected_meta);
+
+            assert_eq!(
+                local.len(&local_result),
+                crate::len(&mut storage, &expected),
+                "The relational product in the shared storage should match the sequential result"
+            );
+        });
+    }
+
+    #[test]
+    fn test_shared_storage_singleton() {
+        let shared = SharedStorage::new();
+        let mut local = shared.local();
+        let mut storage = Storage::new();
+
+        let vector = [1, 2, 3];
+        let ldd = local.singleton(&vector);
+        let expected = singleton(&mut storage, &vector);
+
+        assert_eq!(local.len(&ldd), crate::len(&mut storage, &expected));
+    }
+}
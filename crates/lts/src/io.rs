@@ -10,8 +10,9 @@ use merc_utilities::Timing;
 use crate::LTS;
 use crate::LabelledTransitionSystem;
 use crate::MultiAction;
-use crate::read_aut;
+use crate::read_aut_mmap;
 use crate::read_bcg;
+use crate::read_mlts_mmap;
 use crate::read_lts;
 
 /// Convenience macro to call `GenericLts::apply` with the same function for both variants.
@@ -56,6 +57,8 @@ pub enum LtsFormat {
     Lts,
     /// The CADP BCG format (requires 'cadp' feature)
     Bcg,
+    /// The merc compact binary LTS format
+    Mlts,
 }
 
 /// Guesses the LTS file format from the file extension.
@@ -70,6 +73,8 @@ pub fn guess_lts_format_from_extension(path: &Path, format: Option<LtsFormat>) -
         Some(LtsFormat::Lts)
     } else if path.extension() == Some(OsStr::new("bcg")) {
         Some(LtsFormat::Bcg)
+    } else if path.extension() == Some(OsStr::new("mlts")) {
+        Some(LtsFormat::Mlts)
     } else {
         None
     }
@@ -148,15 +153,13 @@ pub fn read_explicit_lts(
     let mut time_read = timing.start("read_explicit_lts");
 
     let result = match format {
-        LtsFormat::Aut => {
-            let file = File::open(path)?;
-            GenericLts::Aut(read_aut(&file, hidden_labels)?)
-        }
+        LtsFormat::Aut => GenericLts::Aut(read_aut_mmap(path, hidden_labels)?),
         LtsFormat::Lts => {
             let file = File::open(path)?;
             GenericLts::Lts(read_lts(&file, hidden_labels)?)
         }
         LtsFormat::Bcg => GenericLts::Bcg(read_bcg(path, hidden_labels)?),
+        LtsFormat::Mlts => GenericLts::Aut(read_mlts_mmap(path, hidden_labels)?),
     };
 
     time_read.finish();
@@ -3,9 +3,12 @@
 use std::io::BufWriter;
 use std::io::Read;
 use std::io::Write;
+use std::sync::mpsc;
 
 use log::info;
 use merc_io::LargeFormatter;
+use rayon::ThreadPoolBuilder;
+use rayon::prelude::*;
 use regex::Regex;
 use streaming_iterator::StreamingIterator;
 use thiserror::Error;
@@ -144,6 +147,124 @@ pub fn write_aut(writer: &mut impl Write, lts: &impl LTS) -> Result<(), MercErro
     Ok(())
 }
 
+/// The number of states formatted per work item in the parallel writer.
+const WRITE_CHUNK_SIZE: usize = 16384;
+
+/// Same as [write_aut], but formats the transitions with the given number of
+/// worker threads.
+///
+/// # Details
+///
+/// The states are split into chunks that are formatted into per-chunk buffers
+/// in parallel, while a dedicated I/O thread flushes the buffers in order over
+/// a bounded channel. This pipelines the integer and label formatting with the
+/// actual writing, and the output is identical to the sequential writer.
+pub fn write_aut_parallel<W: Write + Send>(
+    writer: &mut W,
+    lts: &(impl LTS + Sync),
+    threads: usize,
+) -> Result<(), MercError> {
+    if threads <= 1 {
+        return write_aut(writer, lts);
+    }
+
+    info!("Writing LTS in .aut format using {threads} worker threads...");
+
+    writeln!(
+        writer,
+        "des ({}, {}, {})",
+        lts.initial_state_index(),
+        lts.num_of_transitions(),
+        lts.num_of_states()
+    )?;
+
+    let pool = ThreadPoolBuilder::new()
+        .num_threads(threads)
+        .build()
+        .expect("Failed to construct the worker thread pool");
+
+    let num_of_transitions = lts.num_of_transitions();
+    let progress = TimeProgress::new(
+        move |written: usize| {
+            info!(
+                "Wrote {} transitions {}%...",
+                LargeFormatter(written),
+                written * 100 / num_of_transitions
+            )
+        },
+        1,
+    );
+
+    let num_of_chunks = lts.num_of_states().div_ceil(WRITE_CHUNK_SIZE);
+    let (sender, receiver) = mpsc::sync_channel::<Vec<u8>>(2 * threads);
+
+    let result = std::thread::scope(|scope| {
+        // The dedicated I/O thread that flushes the formatted buffers in order.
+        let io_thread = scope.spawn(move || -> Result<(), MercError> {
+            while let Ok(buffer) = receiver.recv() {
+                writer.write_all(&buffer)?;
+            }
+
+            Ok(())
+        });
+
+        // Format groups of chunks in parallel, and stream them to the I/O
+        // thread in order so that memory usage stays bounded.
+        let chunks_per_group = 4 * threads;
+        let mut transitions_formatted = 0usize;
+
+        'groups: for group in (0..num_of_chunks).step_by(chunks_per_group) {
+            let buffers: Vec<(Vec<u8>, usize)> = pool.install(|| {
+                (group..(group + chunks_per_group).min(num_of_chunks))
+                    .into_par_iter()
+                    .map(|chunk| {
+                        let begin = chunk * WRITE_CHUNK_SIZE;
+                        let end = (begin + WRITE_CHUNK_SIZE).min(lts.num_of_states());
+
+                        let mut buffer = Vec::new();
+                        let mut num_in_buffer = 0usize;
+                        for state_index in (begin..end).map(StateIndex::new) {
+                            for transition in lts.outgoing_transitions(state_index) {
+                                writeln!(
+                                    buffer,
+                                    "({}, \"{}\", {})",
+                                    state_index,
+                                    lts.labels()[transition.label.value()],
+                                    transition.to
+                                )
+                                .expect("Writing to a vector cannot fail");
+                                num_in_buffer += 1;
+                            }
+                        }
+
+                        (buffer, num_in_buffer)
+                    })
+                    .collect()
+            });
+
+            for (buffer, num_in_buffer) in buffers {
+                if sender.send(buffer).is_err() {
+                    // The I/O thread stopped due to a write error, which is returned below.
+                    break 'groups;
+                }
+
+                transitions_formatted += num_in_buffer;
+                progress.print(transitions_formatted);
+            }
+        }
+
+        // Close the channel so that the I/O thread finishes.
+        drop(sender);
+
+        io_thread.join().expect("The I/O thread should not panic")
+    });
+
+    result?;
+
+    info!("Finished writing LTS.");
+    Ok(())
+}
+
 /// Dedicated function to parse the following transition formats:
 ///
 /// # Details
@@ -257,6 +378,25 @@ mod tests {
         assert!(lts.num_of_transitions() == lts_original.num_of_transitions());
     }
 
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_random_aut_write_parallel() {
+        random_test(100, |rng| {
+            let lts = random_lts_monolithic::<String>(rng, 100, 3, 20);
+
+            let mut expected: Vec<u8> = Vec::new();
+            write_aut(&mut expected, &lts).unwrap();
+
+            let mut buffer: Vec<u8> = Vec::new();
+            write_aut_parallel(&mut buffer, &lts, 4).unwrap();
+
+            assert_eq!(
+                buffer, expected,
+                "The parallel writer should produce the same output as the sequential writer"
+            );
+        })
+    }
+
     #[test]
     #[cfg_attr(miri, ignore)]
     fn test_random_aut_io() {
@@ -0,0 +1,266 @@
+use std::fs::File;
+use std::ops::Range;
+use std::path::Path;
+
+use log::info;
+use log::warn;
+use memmap2::Mmap;
+use rayon::iter::IntoParallelIterator;
+use rayon::iter::ParallelIterator;
+use rustc_hash::FxHashMap;
+
+use merc_io::LargeFormatter;
+use merc_utilities::MercError;
+
+use crate::IOError;
+use crate::LabelIndex;
+use crate::LabelledTransitionSystem;
+use crate::LtsBuilderFast;
+use crate::StateIndex;
+use crate::read_aut;
+
+/// Loads a labelled transition system in the Aldebaran format from the given
+/// path, see [read_aut] for the description of the format.
+///
+/// Memory maps the file and parses it with [read_aut_bytes]. Falls back to the
+/// line based [read_aut] reader when the byte level scanner rejects the input,
+/// for example for exotic label syntax.
+pub fn read_aut_mmap(path: &Path, hidden_labels: Vec<String>) -> Result<LabelledTransitionSystem<String>, MercError> {
+    let file = File::open(path)?;
+
+    // SAFETY: The mapping is read-only and only lives for the duration of the
+    // parse; modifying the file concurrently is undefined behaviour.
+    let bytes = unsafe { Mmap::map(&file)? };
+
+    match read_aut_bytes(&bytes, hidden_labels.clone()) {
+        Ok(lts) => Ok(lts),
+        Err(err) => {
+            warn!("Falling back to the line based .aut reader: {err}");
+            read_aut(&bytes[..], hidden_labels)
+        }
+    }
+}
+
+/// Parses a labelled transition system in the Aldebaran format from the given
+/// bytes, see [read_aut] for the description of the format.
+///
+/// Splits the input into chunks at line boundaries and parses the chunks in
+/// parallel with a byte level scanner, so no regular expressions and no string
+/// allocation per transition. Labels are interned per chunk and the chunk
+/// tables are merged into the [LtsBuilderFast] sequentially.
+pub fn read_aut_bytes(bytes: &[u8], hidden_labels: Vec<String>) -> Result<LabelledTransitionSystem<String>, MercError> {
+    info!("Reading LTS in .aut format...");
+
+    let header_end = bytes.iter().position(|&byte| byte == b'\n').unwrap_or(bytes.len());
+    let (initial_state, num_of_transitions, _num_of_states) = parse_header(&bytes[0..header_end]).ok_or(
+        IOError::InvalidHeader("does not match des (<init>, <num_of_transitions>, <num_of_states>)"),
+    )?;
+
+    let body = bytes.get(header_end + 1..).unwrap_or_default();
+
+    // Several chunks per worker such that work stealing can balance the load.
+    let chunks: Vec<ChunkTransitions> = split_lines(body, 4 * rayon::current_num_threads())
+        .into_par_iter()
+        .map(|range| parse_chunk(&body[range]))
+        .collect::<Result<_, _>>()?;
+
+    info!(
+        "Read {} transitions, merging labels...",
+        LargeFormatter(chunks.iter().map(|chunk| chunk.transitions.len()).sum::<usize>())
+    );
+
+    // Merge the per-chunk label tables, renumbering the local label indices.
+    let mut builder = LtsBuilderFast::with_capacity(Vec::new(), hidden_labels, num_of_transitions);
+    let mut remap: Vec<LabelIndex> = Vec::new();
+
+    for chunk in &chunks {
+        remap.clear();
+        remap.extend(chunk.labels.iter().map(|&label| builder.label_index(label)));
+
+        for &(from, local_label, to) in &chunk.transitions {
+            builder.add_transition_indexed(from, remap[local_label.value()], to);
+        }
+    }
+
+    info!("Finished reading LTS");
+
+    Ok(builder.finish(initial_state, false))
+}
+
+/// The transitions of a chunk of lines, with the labels interned per chunk.
+struct ChunkTransitions<'a> {
+    /// The transitions with chunk local label indices.
+    transitions: Vec<(StateIndex, LabelIndex, StateIndex)>,
+
+    /// The interned labels of the chunk, borrowed from the input.
+    labels: Vec<&'a str>,
+}
+
+/// Parses the transitions of the given chunk of lines, see [read_aut_bytes].
+fn parse_chunk(chunk: &[u8]) -> Result<ChunkTransitions<'_>, IOError> {
+    let mut transitions = Vec::new();
+    let mut labels: Vec<&str> = Vec::new();
+    let mut labels_index: FxHashMap<&[u8], LabelIndex> = FxHashMap::default();
+
+    for line in chunk.split(|&byte| byte == b'\n') {
+        let line = line.trim_ascii();
+        if line.is_empty() {
+            continue;
+        }
+
+        let (from, label, to) = parse_transition(line)
+            .ok_or_else(|| IOError::InvalidTransition(String::from_utf8_lossy(line).into_owned()))?;
+
+        let local_label = if let Some(&index) = labels_index.get(label) {
+            index
+        } else {
+            let index = LabelIndex::new(labels.len());
+            labels.push(
+                str::from_utf8(label)
+                    .map_err(|_| IOError::InvalidTransition(String::from_utf8_lossy(line).into_owned()))?,
+            );
+            labels_index.insert(label, index);
+            index
+        };
+
+        transitions.push((StateIndex::new(from), local_label, StateIndex::new(to)));
+    }
+
+    Ok(ChunkTransitions { transitions, labels })
+}
+
+/// Parses the header `des (<initial>: Nat, <num_of_transitions>: Nat, <num_of_states>: Nat)`.
+fn parse_header(line: &[u8]) -> Option<(StateIndex, usize, usize)> {
+    let rest = line.trim_ascii().strip_prefix(b"des")?;
+
+    let start_paren = rest.iter().position(|&byte| byte == b'(')?;
+    let end_paren = rest.iter().rposition(|&byte| byte == b')')?;
+
+    let mut parts = rest.get(start_paren + 1..end_paren)?.split(|&byte| byte == b',');
+    let initial = parse_number(parts.next()?.trim_ascii())?;
+    let num_of_transitions = parse_number(parts.next()?.trim_ascii())?;
+    let num_of_states = parse_number(parts.next()?.trim_ascii())?;
+
+    if parts.next().is_some() {
+        return None;
+    }
+
+    Some((StateIndex::new(initial), num_of_transitions, num_of_states))
+}
+
+/// Parses a transition line, accepting the same formats as [read_aut]:
+///     `(<from>: Nat, "<label>": Str, <to>: Nat)`
+///     `(<from>: Nat, <label>: Str, <to>: Nat)`
+fn parse_transition(line: &[u8]) -> Option<(usize, &[u8], usize)> {
+    let start_paren = line.iter().position(|&byte| byte == b'(')?;
+    let start_comma = line.iter().position(|&byte| byte == b',')?;
+
+    // Find the comma in the second part
+    let start_second_comma = line.iter().rposition(|&byte| byte == b',')?;
+    let end_paren = line.iter().rposition(|&byte| byte == b')')?;
+
+    let from = parse_number(line.get(start_paren + 1..start_comma)?.trim_ascii())?;
+    let to = parse_number(line.get(start_second_comma + 1..end_paren)?.trim_ascii())?;
+
+    // Handle the special case where it has quotes.
+    let mut label = line.get(start_comma + 1..start_second_comma)?.trim_ascii();
+    if label.len() >= 2 && label.starts_with(b"\"") && label.ends_with(b"\"") {
+        label = &label[1..label.len() - 1];
+    }
+
+    Some((from, label, to))
+}
+
+/// Parses a decimal number consisting only of ASCII digits.
+fn parse_number(bytes: &[u8]) -> Option<usize> {
+    if bytes.is_empty() {
+        return None;
+    }
+
+    let mut value = 0usize;
+    for &byte in bytes {
+        if !byte.is_ascii_digit() {
+            return None;
+        }
+
+        value = value.checked_mul(10)?.checked_add((byte - b'0') as usize)?;
+    }
+
+    Some(value)
+}
+
+/// Splits the input into at most the given number of ranges at line boundaries.
+fn split_lines(bytes: &[u8], num_of_chunks: usize) -> Vec<Range<usize>> {
+    let chunk_size = bytes.len().div_ceil(num_of_chunks.max(1)).max(1);
+    let mut ranges = Vec::new();
+
+    let mut begin = 0;
+    while begin < bytes.len() {
+        let mut end = (begin + chunk_size).min(bytes.len());
+
+        // Extend the chunk to the next line boundary.
+        while end < bytes.len() && bytes[end - 1] != b'\n' {
+            end += 1;
+        }
+
+        ranges.push(begin..end);
+        begin = end;
+    }
+
+    ranges
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    use std::io::Write;
+
+    use merc_utilities::random_test;
+    use test_log::test;
+
+    use crate::LTS;
+    use crate::check_equivalent;
+    use crate::random_lts_monolithic;
+    use crate::write_aut;
+
+    #[test]
+    fn test_reading_aut_bytes() {
+        let file = include_str!("../../../examples/lts/abp.aut");
+
+        let lts = read_aut_bytes(file.as_bytes(), vec![]).unwrap();
+
+        assert_eq!(lts.initial_state_index().value(), 0);
+        assert_eq!(lts.num_of_transitions(), 92);
+    }
+
+    #[test]
+    fn test_reading_aut_mmap() {
+        let file = include_str!("../../../examples/lts/abp.aut");
+
+        let mut temp = tempfile::NamedTempFile::new().unwrap();
+        temp.write_all(file.as_bytes()).unwrap();
+
+        let lts = read_aut_mmap(temp.path(), vec![]).unwrap();
+        let expected = read_aut(file.as_bytes(), vec![]).unwrap();
+
+        check_equivalent(&expected, &lts);
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_random_aut_bytes() {
+        random_test(100, |rng| {
+            let lts = random_lts_monolithic::<String>(rng, 100, 3, 20);
+
+            let mut buffer: Vec<u8> = Vec::new();
+            write_aut(&mut buffer, &lts).unwrap();
+
+            let result_lts = read_aut_bytes(&buffer, vec![]).unwrap();
+            let expected_lts = read_aut(&buffer[0..], vec![]).unwrap();
+
+            check_equivalent(&lts, &result_lts);
+            check_equivalent(&expected_lts, &result_lts);
+        })
+    }
+}
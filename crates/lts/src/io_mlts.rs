@@ -0,0 +1,311 @@
+use std::fs::File;
+use std::io::BufReader;
+use std::io::BufWriter;
+use std::io::Read;
+use std::io::Write;
+use std::path::Path;
+
+use log::info;
+use memmap2::Mmap;
+
+use merc_io::BitStreamRead;
+use merc_io::BitStreamReader;
+use merc_io::BitStreamWrite;
+use merc_io::BitStreamWriter;
+use merc_io::LargeFormatter;
+use merc_io::TimeProgress;
+use merc_utilities::MercError;
+
+use crate::LTS;
+use crate::LabelIndex;
+use crate::LabelledTransitionSystem;
+use crate::LtsBuilderFast;
+use crate::StateIndex;
+
+/// The magic marker at the start of every .mlts file.
+const MLTS_MAGIC: &str = "MLTS";
+
+/// The current version of the .mlts format.
+const MLTS_VERSION: u64 = 1;
+
+/// Write a labelled transition system in the compact binary .mlts format to
+/// the given writer. Note that the writer is buffered internally using a
+/// `BufWriter`.
+///
+/// # Details
+///
+/// The format uses the variable-length integer encoding of [BitStreamWriter]
+/// throughout. The structure is as follows:
+///
+/// ```plain
+///     magic: "MLTS" Str
+///     version: Nat
+///     initial_state: Nat
+///     num_of_states: Nat
+///     num_of_transitions: Nat
+///     num_of_labels: Nat
+///     labels: num_of_labels x Str
+///     per state, in order:
+///         out_degree: Nat
+///         per outgoing transition: label: Nat, to: Nat
+/// ```
+///
+/// Grouping the transitions by source state avoids storing the from state per
+/// transition, and the header counts allow a reader to preallocate exactly.
+pub fn write_mlts<L>(writer: &mut impl Write, lts: &L) -> Result<(), MercError>
+where
+    L: LTS<Label = String>,
+{
+    info!("Writing LTS in .mlts format...");
+
+    let mut writer = BitStreamWriter::new(BufWriter::new(writer));
+
+    writer.write_string(MLTS_MAGIC)?;
+    writer.write_integer(MLTS_VERSION)?;
+    writer.write_integer(lts.initial_state_index().value() as u64)?;
+    writer.write_integer(lts.num_of_states() as u64)?;
+    writer.write_integer(lts.num_of_transitions() as u64)?;
+
+    writer.write_integer(lts.num_of_labels() as u64)?;
+    for label in lts.labels() {
+        writer.write_string(label)?;
+    }
+
+    let num_of_transitions = lts.num_of_transitions();
+    let progress = TimeProgress::new(
+        move |written: usize| {
+            info!(
+                "Wrote {} transitions {}%...",
+                LargeFormatter(written),
+                written * 100 / num_of_transitions
+            )
+        },
+        1,
+    );
+
+    let mut transitions_written = 0usize;
+    for state_index in lts.iter_states() {
+        writer.write_integer(lts.outgoing_transitions(state_index).count() as u64)?;
+
+        for transition in lts.outgoing_transitions(state_index) {
+            writer.write_integer(transition.label.value() as u64)?;
+            writer.write_integer(transition.to.value() as u64)?;
+
+            progress.print(transitions_written);
+            transitions_written += 1;
+        }
+    }
+
+    writer.flush()?;
+
+    info!("Finished writing LTS.");
+    Ok(())
+}
+
+/// A streaming reader for the binary .mlts format, see [write_mlts].
+///
+/// Constructing the reader only parses the header and the label table, so the
+/// counts and labels are available without reading the transitions. The
+/// transitions can then be streamed with [MltsReader::next_transition] without
+/// materialising the whole transition system.
+pub struct MltsReader<R: Read> {
+    reader: BitStreamReader<R>,
+
+    initial_state: StateIndex,
+    num_of_states: usize,
+    num_of_transitions: usize,
+    labels: Vec<String>,
+
+    /// The source state of the current transition group.
+    current_state: usize,
+
+    /// The number of remaining transitions of the current group.
+    remaining: usize,
+}
+
+impl<R: Read> MltsReader<R> {
+    /// Parses the header and label table from the given reader.
+    pub fn new(reader: R) -> Result<MltsReader<R>, MercError> {
+        let mut reader = BitStreamReader::new(reader);
+
+        if reader.read_string()? != MLTS_MAGIC {
+            return Err("Stream does not contain a labelled transition system in .mlts format.".into());
+        }
+
+        let version = reader.read_integer()?;
+        if version != MLTS_VERSION {
+            return Err(format!("Unsupported .mlts version {version}.").into());
+        }
+
+        let initial_state = StateIndex::new(reader.read_integer()? as usize);
+        let num_of_states = reader.read_integer()? as usize;
+        let num_of_transitions = reader.read_integer()? as usize;
+
+        let num_of_labels = reader.read_integer()? as usize;
+        let mut labels = Vec::with_capacity(num_of_labels);
+        for _ in 0..num_of_labels {
+            labels.push(reader.read_string()?);
+        }
+
+        Ok(MltsReader {
+            reader,
+            initial_state,
+            num_of_states,
+            num_of_transitions,
+            labels,
+            current_state: 0,
+            remaining: 0,
+        })
+    }
+
+    /// Returns the initial state of the transition system.
+    pub fn initial_state_index(&self) -> StateIndex {
+        self.initial_state
+    }
+
+    /// Returns the number of states in the transition system.
+    pub fn num_of_states(&self) -> usize {
+        self.num_of_states
+    }
+
+    /// Returns the number of transitions in the transition system.
+    pub fn num_of_transitions(&self) -> usize {
+        self.num_of_transitions
+    }
+
+    /// Returns the label table of the transition system.
+    pub fn labels(&self) -> &[String] {
+        &self.labels
+    }
+
+    /// Reads the next transition, or None when all transitions have been read.
+    pub fn next_transition(&mut self) -> Result<Option<(StateIndex, LabelIndex, StateIndex)>, MercError> {
+        while self.remaining == 0 {
+            if self.current_state >= self.num_of_states {
+                return Ok(None);
+            }
+
+            self.remaining = self.reader.read_integer()? as usize;
+            self.current_state += 1;
+        }
+
+        let label = LabelIndex::new(self.reader.read_integer()? as usize);
+        let to = StateIndex::new(self.reader.read_integer()? as usize);
+        self.remaining -= 1;
+
+        let from = StateIndex::new(self.current_state - 1);
+        if label.value() >= self.labels.len() || to.value() >= self.num_of_states {
+            return Err(format!("Invalid transition {from} --[{label}]-> {to} in .mlts stream.").into());
+        }
+
+        Ok(Some((from, label, to)))
+    }
+
+    /// Reads the remaining transitions into a labelled transition system.
+    pub fn read_lts(mut self, hidden_labels: Vec<String>) -> Result<LabelledTransitionSystem<String>, MercError> {
+        // Pass the label table to the builder so hidden labels are mapped to tau.
+        let mut builder =
+            LtsBuilderFast::with_capacity(self.labels.clone(), hidden_labels, self.num_of_transitions);
+
+        // The builder reorders the labels, so renumber the label indices.
+        let remap: Vec<LabelIndex> = self.labels.iter().map(|label| builder.label_index(label)).collect();
+
+        while let Some((from, label, to)) = self.next_transition()? {
+            builder.add_transition_indexed(from, remap[label.value()], to);
+        }
+
+        builder.require_num_of_states(self.num_of_states);
+        Ok(builder.finish(self.initial_state, false))
+    }
+}
+
+/// Loads a labelled transition system in the binary .mlts format from the
+/// given reader, see [write_mlts].
+pub fn read_mlts(reader: impl Read, hidden_labels: Vec<String>) -> Result<LabelledTransitionSystem<String>, MercError> {
+    info!("Reading LTS in .mlts format...");
+
+    let lts = MltsReader::new(BufReader::new(reader))?.read_lts(hidden_labels)?;
+
+    info!("Finished reading LTS.");
+    Ok(lts)
+}
+
+/// Loads a labelled transition system in the binary .mlts format from the
+/// given path through a memory map, avoiding read system calls and double
+/// buffering while streaming the transitions.
+pub fn read_mlts_mmap(path: &Path, hidden_labels: Vec<String>) -> Result<LabelledTransitionSystem<String>, MercError> {
+    let file = File::open(path)?;
+
+    // SAFETY: The mapping is read-only and only lives for the duration of the
+    // parse; modifying the file concurrently is undefined behaviour.
+    let bytes = unsafe { Mmap::map(&file)? };
+
+    info!("Reading LTS in .mlts format...");
+
+    let lts = MltsReader::new(&bytes[..])?.read_lts(hidden_labels)?;
+
+    info!("Finished reading LTS.");
+    Ok(lts)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    use std::io::Write;
+
+    use merc_utilities::random_test;
+    use test_log::test;
+
+    use crate::check_equivalent;
+    use crate::random_lts_monolithic;
+    use crate::read_aut;
+
+    #[test]
+    fn test_mlts_roundtrip() {
+        let file = include_str!("../../../examples/lts/abp.aut");
+        let lts = read_aut(file.as_bytes(), vec![]).unwrap();
+
+        let mut buffer: Vec<u8> = Vec::new();
+        write_mlts(&mut buffer, &lts).unwrap();
+
+        let reader = MltsReader::new(&buffer[..]).unwrap();
+        assert_eq!(reader.initial_state_index(), lts.initial_state_index());
+        assert_eq!(reader.num_of_states(), lts.num_of_states());
+        assert_eq!(reader.num_of_transitions(), lts.num_of_transitions());
+        assert_eq!(reader.labels().len(), lts.num_of_labels());
+
+        let result_lts = reader.read_lts(vec![]).unwrap();
+        check_equivalent(&lts, &result_lts);
+    }
+
+    #[test]
+    fn test_mlts_mmap() {
+        let file = include_str!("../../../examples/lts/abp.aut");
+        let lts = read_aut(file.as_bytes(), vec![]).unwrap();
+
+        let mut buffer: Vec<u8> = Vec::new();
+        write_mlts(&mut buffer, &lts).unwrap();
+
+        let mut temp = tempfile::NamedTempFile::new().unwrap();
+        temp.write_all(&buffer).unwrap();
+
+        let result_lts = read_mlts_mmap(temp.path(), vec![]).unwrap();
+        check_equivalent(&lts, &result_lts);
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_random_mlts_io() {
+        random_test(100, |rng| {
+            let lts = random_lts_monolithic::<String>(rng, 100, 3, 20);
+
+            let mut buffer: Vec<u8> = Vec::new();
+            write_mlts(&mut buffer, &lts).unwrap();
+
+            let result_lts = read_mlts(&buffer[0..], vec![]).unwrap();
+
+            check_equivalent(&lts, &result_lts);
+        })
+    }
+}
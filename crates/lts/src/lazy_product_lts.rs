@@ -0,0 +1,326 @@
+#![forbid(unsafe_code)]
+
+use std::cell::RefCell;
+
+use merc_collections::IndexedSet;
+
+use crate::LTS;
+use crate::LabelIndex;
+use crate::LabelledTransitionSystem;
+use crate::StateIndex;
+use crate::Transition;
+use crate::TransitionLabel;
+
+/// The synchronous product of two LTSs that generates product states on demand.
+///
+/// Implements the [LTS] trait such that it can be used wherever a materialized
+/// product would be used. States are numbered in discovery order by an internal
+/// [IndexedSet], and the outgoing transitions of a product state are computed
+/// the first time they are requested. Algorithms that only visit a fraction of
+/// the product, such as the antichain based refinement checks, therefore never
+/// pay for the unreachable or unvisited part.
+///
+/// The synchronisation convention is the same as for [crate::product_lts]: if
+/// `synchronized_labels` is `None`, then all common labels (except tau) are
+/// considered synchronized. Otherwise, the provided labels are used for
+/// synchronization.
+pub struct LazyProductLts<'a, L: LTS, R: LTS<Label = L::Label>> {
+    left: &'a L,
+    right: &'a R,
+
+    /// The combined action labels of both LTSs.
+    labels: Vec<L::Label>,
+
+    /// Maps the label indices of the left resp. right LTS to indices into `labels`.
+    left_labels: Vec<LabelIndex>,
+    right_labels: Vec<LabelIndex>,
+
+    /// For every combined label whether it is a synchronised label.
+    synchronised: Vec<bool>,
+
+    /// The part of the product discovered so far, behind a `RefCell` since
+    /// discovery happens during the immutable [LTS::outgoing_transitions].
+    explored: RefCell<Explored>,
+}
+
+/// The product states discovered so far and their cached outgoing transitions.
+struct Explored {
+    /// Assigns consecutive state numbers to the discovered (left, right) pairs.
+    states: IndexedSet<(StateIndex, StateIndex)>,
+
+    /// The (left, right) pair for every discovered product state.
+    pairs: Vec<(StateIndex, StateIndex)>,
+
+    /// The outgoing transitions for every discovered product state, computed on demand.
+    successors: Vec<Option<Vec<Transition>>>,
+
+    /// The total number of cached transitions.
+    num_of_transitions: usize,
+}
+
+impl<'a, L: LTS, R: LTS<Label = L::Label>> LazyProductLts<'a, L, R> {
+    /// Creates the lazy product of the two given LTSs, discovering only the initial state.
+    pub fn new(left: &'a L, right: &'a R, synchronized_labels: Option<Vec<L::Label>>) -> Self {
+        // Determine the combination of action labels.
+        let mut all_labels: IndexedSet<L::Label> = IndexedSet::new();
+
+        let mut left_labels = Vec::with_capacity(left.num_of_labels());
+        for label in left.labels() {
+            let (index, _) = all_labels.insert(label.clone());
+            left_labels.push(LabelIndex::new(*index));
+        }
+
+        // Determine the synchronised labels.
+        let mut right_labels = Vec::with_capacity(right.num_of_labels());
+        let synchronised_labels = match synchronized_labels {
+            Some(x) => {
+                for label in right.labels() {
+                    let (index, _) = all_labels.insert(label.clone());
+                    right_labels.push(LabelIndex::new(*index));
+                }
+                x
+            }
+            None => {
+                let mut new_synchronized_labels: Vec<L::Label> = Vec::new();
+                for label in right.labels() {
+                    let (index, inserted) = all_labels.insert(label.clone());
+                    right_labels.push(LabelIndex::new(*index));
+
+                    if !inserted {
+                        new_synchronized_labels.push(label.clone());
+                    }
+                }
+
+                // Tau can never be synchronised.
+                new_synchronized_labels.retain(|l| !l.is_tau_label());
+                new_synchronized_labels
+            }
+        };
+
+        let labels = all_labels.to_vec();
+        let synchronised = labels.iter().map(|l| synchronised_labels.contains(l)).collect();
+
+        let mut explored = Explored {
+            states: IndexedSet::new(),
+            pairs: Vec::new(),
+            successors: Vec::new(),
+            num_of_transitions: 0,
+        };
+        explored.state_of(left.initial_state_index(), right.initial_state_index());
+
+        Self {
+            left,
+            right,
+            labels,
+            left_labels,
+            right_labels,
+            synchronised,
+            explored: RefCell::new(explored),
+        }
+    }
+
+    /// Returns the pair of the left and right state that the given product state represents.
+    ///
+    /// Panics when the state has not been discovered yet.
+    pub fn state_pair(&self, state_index: StateIndex) -> (StateIndex, StateIndex) {
+        self.explored.borrow().pairs[state_index.value()]
+    }
+
+    /// Returns the outgoing transitions of the given product state, discovering
+    /// its successor states when they have not been seen before.
+    fn successors(&self, state_index: StateIndex) -> Vec<Transition> {
+        let mut explored = self.explored.borrow_mut();
+        if let Some(transitions) = &explored.successors[state_index.value()] {
+            return transitions.clone();
+        }
+
+        let (left_state, right_state) = explored.pairs[state_index.value()];
+        let mut transitions = Vec::new();
+
+        // Add transitions for the left LTS.
+        for left_transition in self.left.outgoing_transitions(left_state) {
+            let label = self.left_labels[left_transition.label.value()];
+
+            if self.synchronised[label.value()] {
+                // (left, right) -[a]-> (left', right') iff left -[a]-> left' and right -[a]-> right', and a is a synchronous action.
+                for right_transition in self.right.outgoing_transitions(right_state) {
+                    if self.right_labels[right_transition.label.value()] == label {
+                        let to = explored.state_of(left_transition.to, right_transition.to);
+                        transitions.push(Transition::new(label, to));
+                    }
+                }
+            } else {
+                // (left, right) -[a]-> (left', right) iff left -[a]-> left' and a is not a synchronous action.
+                let to = explored.state_of(left_transition.to, right_state);
+                transitions.push(Transition::new(label, to));
+            }
+        }
+
+        // (left, right) -[a]-> (left, right') iff right -[a]-> right' and a is not a synchronous action.
+        for right_transition in self.right.outgoing_transitions(right_state) {
+            let label = self.right_labels[right_transition.label.value()];
+            if !self.synchronised[label.value()] {
+                let to = explored.state_of(left_state, right_transition.to);
+                transitions.push(Transition::new(label, to));
+            }
+        }
+
+        // Synchronisation can produce the same product transition through different
+        // pairs, so remove duplicates like the materialized construction does.
+        transitions.sort();
+        transitions.dedup();
+
+        explored.num_of_transitions += transitions.len();
+        explored.successors[state_index.value()] = Some(transitions.clone());
+        transitions
+    }
+
+    /// Explores the full reachable product and returns it as a materialized LTS.
+    pub fn into_concrete(self) -> LabelledTransitionSystem<L::Label> {
+        // Discover all reachable states; `successors` extends the state set so
+        // iterate until no new states appear.
+        let mut state = 0;
+        while state < self.explored.borrow().pairs.len() {
+            self.successors(StateIndex::new(state));
+            state += 1;
+        }
+
+        let explored = self.explored.into_inner();
+        LabelledTransitionSystem::new(
+            StateIndex::new(0),
+            Some(explored.pairs.len()),
+            || {
+                explored.successors.iter().enumerate().flat_map(|(from, transitions)| {
+                    transitions
+                        .as_ref()
+                        .expect("All states have been explored")
+                        .iter()
+                        .map(move |t| (StateIndex::new(from), t.label, t.to))
+                })
+            },
+            self.labels,
+        )
+    }
+}
+
+impl Explored {
+    /// Returns the product state for the given pair, discovering it when it is new.
+    fn state_of(&mut self, left_state: StateIndex, right_state: StateIndex) -> StateIndex {
+        let (index, inserted) = self.states.insert((left_state, right_state));
+        if inserted {
+            self.pairs.push((left_state, right_state));
+            self.successors.push(None);
+        }
+
+        StateIndex::new(*index)
+    }
+}
+
+impl<L: LTS, R: LTS<Label = L::Label>> LTS for LazyProductLts<'_, L, R> {
+    type Label = L::Label;
+
+    fn initial_state_index(&self) -> StateIndex {
+        StateIndex::new(0)
+    }
+
+    fn outgoing_transitions(&self, state_index: StateIndex) -> impl Iterator<Item = Transition> + '_ {
+        self.successors(state_index).into_iter()
+    }
+
+    /// Iterates over the product states discovered so far.
+    fn iter_states(&self) -> impl Iterator<Item = StateIndex> + '_ {
+        (0..self.num_of_states()).map(StateIndex::new)
+    }
+
+    /// Returns the number of product states discovered so far, which grows as
+    /// the product is explored.
+    fn num_of_states(&self) -> usize {
+        self.explored.borrow().pairs.len()
+    }
+
+    fn num_of_labels(&self) -> usize {
+        self.labels.len()
+    }
+
+    /// Returns the number of transitions of the product states explored so far.
+    fn num_of_transitions(&self) -> usize {
+        self.explored.borrow().num_of_transitions
+    }
+
+    fn labels(&self) -> &[Self::Label] {
+        &self.labels[0..]
+    }
+
+    fn is_hidden_label(&self, label_index: LabelIndex) -> bool {
+        self.labels[label_index.value()].is_tau_label()
+    }
+
+    fn merge_disjoint<T: LTS<Label = Self::Label>>(
+        self,
+        other: &T,
+    ) -> (LabelledTransitionSystem<Self::Label>, StateIndex) {
+        // Merging requires the full product, so materialize it first.
+        self.into_concrete().merge_disjoint(other)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    use merc_io::DumpFiles;
+    use test_log::test;
+
+    use merc_utilities::random_test;
+
+    use crate::product_lts;
+    use crate::random_lts;
+    use crate::write_aut;
+
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_random_lazy_product_lts() {
+        random_test(100, |rng| {
+            let mut files = DumpFiles::new("test_random_lazy_product_lts");
+
+            let left = random_lts(rng, 10, 3, 3);
+            let right = random_lts(rng, 10, 3, 3);
+
+            files.dump("left.aut", |f| write_aut(f, &left)).unwrap();
+            files.dump("right.aut", |f| write_aut(f, &right)).unwrap();
+
+            let product = product_lts(&left, &right, None);
+            let lazy_product = LazyProductLts::new(&left, &right, None);
+
+            // Explore the lazy product in the same depth first order as the
+            // eager construction, such that both assign the same state numbers.
+            let mut working = vec![lazy_product.initial_state_index()];
+            while let Some(state) = working.pop() {
+                let known = lazy_product.num_of_states();
+                let _ = lazy_product.outgoing_transitions(state).count();
+
+                // Newly discovered states have indices beyond the previously known ones.
+                for new_state in known..lazy_product.num_of_states() {
+                    working.push(StateIndex::new(new_state));
+                }
+            }
+
+            assert_eq!(lazy_product.num_of_states(), product.num_of_states());
+            assert_eq!(lazy_product.num_of_transitions(), product.num_of_transitions());
+
+            for state in product.iter_states() {
+                let mut expected: Vec<Transition> = product.outgoing_transitions(state).collect();
+                let mut found: Vec<Transition> = lazy_product.outgoing_transitions(state).collect();
+                expected.sort();
+                found.sort();
+
+                assert_eq!(found, expected, "Mismatch in the transitions of state {state}");
+            }
+
+            // Materializing the explored lazy product yields the eager product.
+            let concrete = lazy_product.into_concrete();
+            assert_eq!(concrete.num_of_states(), product.num_of_states());
+            assert_eq!(concrete.num_of_transitions(), product.num_of_transitions());
+        });
+    }
+}
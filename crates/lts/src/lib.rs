@@ -1,27 +1,33 @@
 #![doc = include_str!("../README.md")]
 
-mod incoming_transitions;
 mod io;
 mod io_aut;
+mod io_aut_fast;
 mod io_bcg;
 mod io_lts;
+mod io_mlts;
 mod labelled_transition_system;
+mod lazy_product_lts;
 mod lts;
 mod lts_builder;
 mod lts_builder_fast;
 mod multi_action;
 mod product_lts;
 mod random_lts;
+mod transition_table;
 
-pub use incoming_transitions::*;
 pub use io::*;
 pub use io_aut::*;
+pub use io_aut_fast::*;
 pub use io_bcg::*;
 pub use io_lts::*;
+pub use io_mlts::*;
 pub use labelled_transition_system::*;
+pub use lazy_product_lts::*;
 pub use lts::*;
 pub use lts_builder::*;
 pub use lts_builder_fast::*;
 pub use multi_action::*;
 pub use product_lts::*;
 pub use random_lts::*;
+pub use transition_table::*;
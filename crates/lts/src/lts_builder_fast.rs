@@ -69,21 +69,36 @@ impl<L: TransitionLabel> LtsBuilderFast<L> {
     pub fn add_transition<Q>(&mut self, from: StateIndex, label: &Q, to: StateIndex)
     where
         L: Borrow<Q>,
-        Q: ToOwned<Owned = L> + Eq + Hash,
+        Q: ?Sized + ToOwned<Owned = L> + Eq + Hash,
     {
-        let label_index = if let Some(&index) = self.labels_index.get(label) {
+        let label_index = self.label_index(label);
+        self.add_transition_indexed(from, label_index, to);
+    }
+
+    /// Adds a transition with an already resolved label index, see [LtsBuilderFast::label_index].
+    pub fn add_transition_indexed(&mut self, from: StateIndex, label_index: LabelIndex, to: StateIndex) {
+        debug_assert!(label_index.value() < self.labels.len(), "The label index is out of bounds");
+
+        self.transitions.push((from, label_index, to));
+
+        // Update the number of states.
+        self.num_of_states = self.num_of_states.max(from.value() + 1).max(to.value() + 1);
+    }
+
+    /// Returns the index of the given label, inserting it when it is new.
+    pub fn label_index<Q>(&mut self, label: &Q) -> LabelIndex
+    where
+        L: Borrow<Q>,
+        Q: ?Sized + ToOwned<Owned = L> + Eq + Hash,
+    {
+        if let Some(&index) = self.labels_index.get(label) {
             index
         } else {
             let index = LabelIndex::new(self.labels.len());
             self.labels_index.insert(label.to_owned(), index);
             self.labels.push(label.to_owned());
             index
-        };
-
-        self.transitions.push((from, label_index, to));
-
-        // Update the number of states.
-        self.num_of_states = self.num_of_states.max(from.value() + 1).max(to.value() + 1);
+        }
     }
 
     /// Finalizes the builder and returns the constructed labelled transition system.
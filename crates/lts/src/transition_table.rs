@@ -0,0 +1,236 @@
+#![forbid(unsafe_code)]
+
+use merc_collections::ByteCompressedVec;
+use merc_collections::bytevec;
+
+use crate::LTS;
+use crate::LabelIndex;
+use crate::StateIndex;
+use crate::Transition;
+
+/// Structure-of-arrays storage for the transitions of a labelled transition
+/// system with CSR-style secondary indices grouped by label and by target
+/// state.
+///
+/// # Details
+///
+/// The flat `from`, `label` and `to` arrays are stored once in the state-major
+/// order of the LTS. The label-grouped and incoming views are permutations of
+/// transition indices into these arrays, so both label-major and target-major
+/// scans are sequential memory walks and the incoming transitions are not a
+/// duplicated copy of the transition multiset.
+pub struct TransitionTable {
+    /// The flat transition arrays in the state-major order of the LTS.
+    transition_from: ByteCompressedVec<StateIndex>,
+    transition_labels: ByteCompressedVec<LabelIndex>,
+    transition_to: ByteCompressedVec<StateIndex>,
+
+    /// The offset into `by_label` for every label, with a sentinel entry.
+    label2transition: ByteCompressedVec<usize>,
+
+    /// The permutation of transition indices grouped by label.
+    by_label: ByteCompressedVec<usize>,
+
+    /// The offset into `by_target` for every state, with a sentinel entry.
+    state2incoming: ByteCompressedVec<usize>,
+
+    /// The permutation of transition indices grouped by target state. Within a
+    /// target the transitions are sorted by label, so silent transitions come
+    /// first.
+    by_target: ByteCompressedVec<usize>,
+}
+
+impl TransitionTable {
+    pub fn new(lts: &impl LTS) -> Self {
+        let num_of_transitions = lts.num_of_transitions();
+
+        // Fill the flat transition arrays in state-major order.
+        let mut transition_from = bytevec![StateIndex::new(0); num_of_transitions];
+        let mut transition_labels = bytevec![LabelIndex::new(0); num_of_transitions];
+        let mut transition_to = bytevec![StateIndex::new(0); num_of_transitions];
+
+        let mut index = 0;
+        for state_index in lts.iter_states() {
+            for transition in lts.outgoing_transitions(state_index) {
+                transition_from.set(index, state_index);
+                transition_labels.set(index, transition.label);
+                transition_to.set(index, transition.to);
+                index += 1;
+            }
+        }
+
+        // Group the transition indices by label with a counting sort.
+        let mut label2transition = bytevec![0usize; lts.num_of_labels()];
+        let mut by_label = bytevec![num_of_transitions; num_of_transitions];
+
+        for i in 0..num_of_transitions {
+            label2transition.update(transition_labels.index(i).value(), |start| *start += 1);
+        }
+
+        label2transition.fold(0, |offset, start| {
+            let new_offset = offset + *start;
+            *start = offset;
+            new_offset
+        });
+
+        for i in 0..num_of_transitions {
+            label2transition.update(transition_labels.index(i).value(), |start| {
+                by_label.set(*start, i);
+                *start += 1;
+            });
+        }
+
+        label2transition.fold(0, |previous, start| {
+            let result = *start;
+            *start = previous;
+            result
+        });
+
+        label2transition.push(num_of_transitions);
+
+        // Group the transition indices by target state with a second counting
+        // sort. Processing them in `by_label` order keeps the counting sort
+        // stable, so within every target the transitions are sorted by label.
+        let mut state2incoming = bytevec![0usize; lts.num_of_states()];
+        let mut by_target = bytevec![num_of_transitions; num_of_transitions];
+
+        for i in 0..num_of_transitions {
+            state2incoming.update(transition_to.index(i).value(), |start| *start += 1);
+        }
+
+        state2incoming.fold(0, |offset, start| {
+            let new_offset = offset + *start;
+            *start = offset;
+            new_offset
+        });
+
+        for i in 0..num_of_transitions {
+            let transition = by_label.index(i);
+            state2incoming.update(transition_to.index(transition).value(), |start| {
+                by_target.set(*start, transition);
+                *start += 1;
+            });
+        }
+
+        state2incoming.fold(0, |previous, start| {
+            let result = *start;
+            *start = previous;
+            result
+        });
+
+        state2incoming.push(num_of_transitions);
+
+        Self {
+            transition_from,
+            transition_labels,
+            transition_to,
+            label2transition,
+            by_label,
+            state2incoming,
+            by_target,
+        }
+    }
+
+    /// Returns the number of transitions in the table.
+    pub fn num_of_transitions(&self) -> usize {
+        self.transition_from.len()
+    }
+
+    /// Returns an iterator over all (from, to) pairs with the given label, in a
+    /// sequential scan over the label-grouped index.
+    pub fn transitions_with_label(&self, label: LabelIndex) -> impl Iterator<Item = (StateIndex, StateIndex)> + '_ {
+        let start = self.label2transition.index(label.value());
+        let end = self.label2transition.index(label.value() + 1);
+
+        self.by_label
+            .iter_range(start, end)
+            .map(move |i| (self.transition_from.index(i), self.transition_to.index(i)))
+    }
+
+    /// Returns an iterator over the incoming transitions for the given state,
+    /// where the `to` field of the transition is the source state.
+    pub fn incoming_transitions(&self, state_index: StateIndex) -> impl Iterator<Item = Transition> + '_ {
+        let start = self.state2incoming.index(state_index.value());
+        let end = self.state2incoming.index(state_index.value() + 1);
+
+        self.by_target
+            .iter_range(start, end)
+            .map(move |i| Transition::new(self.transition_labels.index(i), self.transition_from.index(i)))
+    }
+
+    /// Return an iterator over the incoming silent transitions for the given state.
+    pub fn incoming_silent_transitions(&self, state_index: StateIndex) -> impl Iterator<Item = Transition> + '_ {
+        self.incoming_transitions(state_index)
+            .take_while(|transition| transition.label == 0)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    use merc_io::DumpFiles;
+    use merc_utilities::random_test;
+
+    use crate::random_lts;
+
+    #[test]
+    fn test_random_transition_table() {
+        random_test(100, |rng| {
+            let mut files = DumpFiles::new("test_random_transition_table");
+
+            let lts = random_lts(rng, 10, 3, 3);
+            files.dump("input.aut", |f| crate::write_aut(f, &lts)).unwrap();
+            let table = TransitionTable::new(&lts);
+
+            // Check that for every outgoing transition there is an incoming transition.
+            for state_index in lts.iter_states() {
+                for transition in lts.outgoing_transitions(state_index) {
+                    let found = table
+                        .incoming_transitions(transition.to)
+                        .any(|incoming| incoming.label == transition.label && incoming.to == state_index);
+                    assert!(
+                        found,
+                        "Outgoing transition ({state_index}, {transition:?}) should have an incoming transition"
+                    );
+                }
+            }
+
+            // Check that all incoming transitions belong to some outgoing transition.
+            for state_index in lts.iter_states() {
+                for transition in table.incoming_transitions(state_index) {
+                    let found = lts
+                        .outgoing_transitions(transition.to)
+                        .any(|outgoing| outgoing.label == transition.label && outgoing.to == state_index);
+                    assert!(
+                        found,
+                        "Incoming transition ({transition:?}, {state_index}) should have an outgoing transition"
+                    );
+                }
+            }
+
+            // Check that the label-grouped view yields exactly the transitions of the LTS.
+            let mut expected: Vec<(StateIndex, LabelIndex, StateIndex)> = lts
+                .iter_states()
+                .flat_map(|state_index| {
+                    lts.outgoing_transitions(state_index)
+                        .map(move |transition| (state_index, transition.label, transition.to))
+                })
+                .collect();
+            expected.sort();
+
+            let mut grouped: Vec<(StateIndex, LabelIndex, StateIndex)> = (0..lts.num_of_labels())
+                .flat_map(|label| {
+                    let label = LabelIndex::new(label);
+                    table.transitions_with_label(label).map(move |(from, to)| (from, label, to))
+                })
+                .collect();
+            grouped.sort();
+
+            assert_eq!(
+                grouped, expected,
+                "The label-grouped view should yield the transitions of the LTS"
+            );
+        });
+    }
+}
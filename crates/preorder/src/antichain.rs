@@ -7,8 +7,17 @@ use merc_collections::VecSet;
 /// An antichain is a data structure that stores pairs of (s, T) \subset S x 2^S, where `S` is a set of elements that have a total order <.
 /// The antichain maintains the invariant that for any two pairs (s1, T1) and (s2, T2) in the antichain, neither s1 < s2 nor s2 < s1 holds, i.e.,
 /// it is dual to a chain.
+///
+/// # Details
+///
+/// The sets are interned against a per-key universe and encoded as bitsets, so
+/// a dominance check is a handful of word operations instead of a merge over
+/// two sorted vectors. The entries are bucketed by their number of elements
+/// and carry a 64-bit signature, which restricts the subset queries during
+/// insertion to the buckets and signatures that can actually contain a subset
+/// or superset of the new entry.
 pub struct Antichain<K, V> {
-    storage: HashMap<K, VecSet<VecSet<V>>>,
+    storage: HashMap<K, KeyEntries<V>>,
 
     /// The largest size of the antichain.
     max_antichain: usize,
@@ -18,7 +27,84 @@ pub struct Antichain<K, V> {
     antichain_inserts: usize,
 }
 
-impl<K: Eq + Hash, V: Clone + Ord> Antichain<K, V> {
+/// A stored set encoded as a bitset over the per-key universe.
+struct BitEntry {
+    /// The bitwise or of all words. A subset relation between two entries
+    /// implies the subset relation between their signatures, which rejects
+    /// most candidates with a single word operation.
+    signature: u64,
+    /// The bitset words, normalised such that the last word is non-zero.
+    words: Vec<u64>,
+}
+
+impl BitEntry {
+    /// Returns true iff this entry is a subset of the other entry.
+    fn is_subset(&self, other: &BitEntry) -> bool {
+        if self.signature & !other.signature != 0 {
+            return false;
+        }
+
+        // The words are normalised, so a longer entry has a bit beyond the other.
+        self.words.len() <= other.words.len()
+            && self.words.iter().zip(other.words.iter()).all(|(word, other_word)| {
+                word & !other_word == 0
+            })
+    }
+
+    /// Returns the number of elements in this entry.
+    fn len(&self) -> usize {
+        self.words.iter().map(|word| word.count_ones() as usize).sum()
+    }
+}
+
+/// The entries stored for a single key.
+struct KeyEntries<V> {
+    /// Assigns every distinct value a bit position in the universe.
+    index: HashMap<V, usize>,
+    /// The values of the universe in bit position order, used for decoding.
+    values: Vec<V>,
+    /// The stored entries, bucketed by their number of elements. Only smaller
+    /// buckets can contain a subset of a new entry and only larger buckets can
+    /// contain a strict superset.
+    buckets: Vec<Vec<BitEntry>>,
+}
+
+impl<V: Clone + Eq + Hash> KeyEntries<V> {
+    fn new() -> Self {
+        KeyEntries {
+            index: HashMap::new(),
+            values: Vec::new(),
+            buckets: Vec::new(),
+        }
+    }
+
+    /// Encodes the given set against the universe of this key, extending the
+    /// universe with values that have not been seen before.
+    fn encode(&mut self, value: &VecSet<V>) -> BitEntry {
+        let mut words: Vec<u64> = Vec::new();
+
+        for element in value {
+            let bit = *self.index.entry(element.clone()).or_insert_with(|| {
+                self.values.push(element.clone());
+                self.values.len() - 1
+            });
+
+            if bit / 64 >= words.len() {
+                words.resize(bit / 64 + 1, 0);
+            }
+            words[bit / 64] |= 1 << (bit % 64);
+        }
+
+        while words.last() == Some(&0) {
+            words.pop();
+        }
+
+        let signature = words.iter().fold(0, |signature, word| signature | word);
+        BitEntry { signature, words }
+    }
+}
+
+impl<K: Eq + Hash, V: Clone + Ord + Hash> Antichain<K, V> {
     /// Creates a new empty antichain.
     pub fn new() -> Self {
         Antichain {
@@ -32,36 +118,34 @@ impl<K: Eq + Hash, V: Clone + Ord> Antichain<K, V> {
     /// Inserts the given (s, T) pair into the antichain and returns true iff it was
     /// not already present.
     pub fn insert(&mut self, key: K, value: VecSet<V>) -> bool {
+        let entries = self.storage.entry(key).or_insert_with(KeyEntries::new);
+        let entry = entries.encode(&value);
+        let size = entry.len();
+
+        // The new entry is dominated iff some stored entry is a subset of it;
+        // such an entry has at most `size` elements.
+        let contains = entries
+            .buckets
+            .iter()
+            .take(size + 1)
+            .any(|bucket| bucket.iter().any(|stored| stored.is_subset(&entry)));
+
         let mut inserted = false;
-        self.storage
-            .entry(key)
-            .and_modify(|entry| {
-                let mut contains = false;
-                entry.retain(|inner_value| {
-                    if inner_value.is_subset(&value) {
-                        // The new value is a superset of an existing entry
-                        contains = true;
-                        true
-                    } else if value.is_subset(inner_value) {
-                        // Remove any entry that is a superset of the new value
-                        false
-                    } else {
-                        // Leave incomparable entries unchanged
-                        true
-                    }
-                });
-
-                if !contains {
-                    self.antichain_misses += 1; // Was not present
-                    entry.insert(value.clone());
-                    inserted = true;
-                }
-            })
-            .or_insert_with(|| {
-                self.antichain_misses += 1; // Was not present
-                inserted = true;
-                VecSet::singleton(value)
-            });
+        if !contains {
+            // Remove the strict supersets of the new entry; an equal entry
+            // would have been found above, so these have more elements.
+            for bucket in entries.buckets.iter_mut().skip(size + 1) {
+                bucket.retain(|stored| !entry.is_subset(stored));
+            }
+
+            if size >= entries.buckets.len() {
+                entries.buckets.resize_with(size + 1, Vec::new);
+            }
+            entries.buckets[size].push(entry);
+
+            self.antichain_misses += 1; // Was not present
+            inserted = true;
+        }
 
         self.antichain_inserts += 1;
         self.max_antichain = self.max_antichain.max(self.storage.len());
@@ -70,29 +154,24 @@ impl<K: Eq + Hash, V: Clone + Ord> Antichain<K, V> {
     }
 }
 
-impl<K: Eq + Hash, V: Clone + Ord> Default for Antichain<K, V> {
+impl<K: Eq + Hash, V: Clone + Ord + Hash> Default for Antichain<K, V> {
     fn default() -> Self {
         Self::new()
     }
 }
 
-impl<K, V: fmt::Debug + Ord> Antichain<K, V> {
+impl<K, V> Antichain<K, V> {
     /// Checks the internal consistency of the antichain invariant.
     #[cfg(test)]
     fn check_consistency(&self) {
-        for (_key, values) in &self.storage {
-            for i in values.iter() {
-                for j in values.iter() {
-                    if i == j {
-                        // Ignore identical entries
-                        continue;
-                    }
+        for (_key, entries) in &self.storage {
+            let all: Vec<&BitEntry> = entries.buckets.iter().flatten().collect();
 
+            for (i, first) in all.iter().enumerate() {
+                for second in &all[i + 1..] {
                     assert!(
-                        !i.is_subset(j) && !j.is_subset(i),
-                        "Antichain invariant violated: {:?} and {:?} are comparable.",
-                        i,
-                        j
+                        !first.is_subset(second) && !second.is_subset(first),
+                        "Antichain invariant violated: two stored entries are comparable."
                     );
                 }
             }
@@ -103,8 +182,26 @@ impl<K, V: fmt::Debug + Ord> Antichain<K, V> {
 impl<T: fmt::Debug, U: fmt::Debug> fmt::Debug for Antichain<T, U> {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         writeln!(f, "Antichain {{")?;
-        for (key, values) in &self.storage {
-            writeln!(f, "  {:?}: {:?}", key, values)?;
+        for (key, entries) in &self.storage {
+            // Decode the bitsets back into the values of the universe.
+            let decoded: Vec<Vec<&U>> = entries
+                .buckets
+                .iter()
+                .flatten()
+                .map(|entry| {
+                    entries
+                        .values
+                        .iter()
+                        .enumerate()
+                        .filter(|(bit, _)| {
+                            entry.words.get(bit / 64).is_some_and(|word| word & (1 << (bit % 64)) != 0)
+                        })
+                        .map(|(_, value)| value)
+                        .collect()
+                })
+                .collect();
+
+            writeln!(f, "  {:?}: {:?}", key, decoded)?;
         }
         writeln!(f, "}}")
     }
@@ -170,4 +267,40 @@ mod tests {
             antichain.check_consistency();
         })
     }
+
+    /// Compares the bitset-backed antichain against a straightforward
+    /// reference implementation on the stored sets.
+    #[test]
+    fn test_random_antichain_reference() {
+        random_test(100, |rng| {
+            let mut antichain: Antichain<u32, u32> = Antichain::new();
+            let mut reference: Vec<(u32, merc_collections::VecSet<u32>)> = Vec::new();
+
+            for _ in 0..100 {
+                let key = rng.random_range(0..5);
+                let set_size = rng.random_range(1..6);
+                let mut value = vecset![];
+
+                for _ in 0..set_size {
+                    value.insert(rng.random_range(0..100));
+                }
+
+                let expected = !reference
+                    .iter()
+                    .any(|(other_key, other)| *other_key == key && other.is_subset(&value));
+                if expected {
+                    reference.retain(|(other_key, other)| !(*other_key == key && value.is_subset(other)));
+                    reference.push((key, value.clone()));
+                }
+
+                assert_eq!(
+                    antichain.insert(key, value),
+                    expected,
+                    "The antichain must agree with the reference implementation"
+                );
+            }
+
+            antichain.check_consistency();
+        })
+    }
 }
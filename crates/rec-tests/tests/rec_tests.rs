@@ -5,6 +5,7 @@ use merc_aterm::ATerm;
 use merc_data::DataExpression;
 use merc_data::to_untyped_data_expression;
 use merc_rec_tests::load_rec_from_strings;
+use merc_sabre::CompiledRewriter;
 use merc_sabre::InnermostRewriter;
 use merc_sabre::NaiveRewriter;
 use merc_sabre::RewriteEngine;
@@ -30,6 +31,7 @@ fn rec_test(rec_files: Vec<&str>, expected_result: &str) {
     // Test Sabre rewriter
     let mut sa = SabreRewriter::new(&spec);
     let mut inner = InnermostRewriter::new(&spec);
+    let mut compiled = CompiledRewriter::new(&spec);
 
     let mut expected = expected_result.split('\n');
 
@@ -44,6 +46,13 @@ fn rec_test(rec_files: Vec<&str>, expected_result: &str) {
             "The inner rewrite result doesn't match the expected result",
         );
 
+        let result = compiled.rewrite(term);
+        assert_eq!(
+            result,
+            expected_result.clone(),
+            "The compiled rewrite result doesn't match the expected result",
+        );
+
         let result = sa.rewrite(term);
         assert_eq!(
             result, expected_result,
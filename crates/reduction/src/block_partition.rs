@@ -4,7 +4,7 @@ use std::fmt;
 
 use itertools::Itertools;
 
-use merc_lts::IncomingTransitions;
+use merc_lts::TransitionTable;
 use merc_lts::StateIndex;
 
 use super::Partition;
@@ -224,7 +224,7 @@ impl BlockPartition {
 
     /// Makes the marked elements closed under the silent closure of incoming
     /// tau-transitions within the current block.
-    pub fn mark_backward_closure(&mut self, block_index: BlockIndex, incoming_transitions: &IncomingTransitions) {
+    pub fn mark_backward_closure(&mut self, block_index: BlockIndex, incoming_transitions: &TransitionTable) {
         let block = self.blocks[block_index];
         let mut it = block.end - 1;
 
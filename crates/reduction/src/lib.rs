@@ -6,10 +6,14 @@ mod indexed_partition;
 mod quotient;
 mod reduce;
 mod scc_decomposition;
+mod scc_decomposition_parallel;
 mod signature_refinement;
+mod signature_refinement_parallel;
+mod signature_table;
 mod signatures;
 mod simple_block_partition;
 mod sort_topological;
+mod tau_reachability;
 mod weak_bisimulation;
 
 pub use block_partition::*;
@@ -18,8 +22,12 @@ pub use indexed_partition::*;
 pub use quotient::*;
 pub use reduce::*;
 pub use scc_decomposition::*;
+pub use scc_decomposition_parallel::*;
 pub use signature_refinement::*;
+pub use signature_refinement_parallel::*;
+pub use signature_table::*;
 pub use signatures::*;
 pub use simple_block_partition::*;
 pub use sort_topological::*;
+pub use tau_reachability::*;
 pub use weak_bisimulation::*;
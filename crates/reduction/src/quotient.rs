@@ -1,6 +1,8 @@
 #![forbid(unsafe_code)]
 
+use merc_collections::VecSet;
 use merc_lts::LTS;
+use merc_lts::LabelIndex;
 use merc_lts::LabelledTransitionSystem;
 use merc_lts::LtsBuilderFast;
 use merc_lts::StateIndex;
@@ -78,6 +80,63 @@ pub fn quotient_lts_naive<L: LTS>(
     )
 }
 
+/// Returns a new LTS based on the given partition, deduplicating the transitions on the fly.
+///
+/// The naive version collects the quotiented transitions of all states before
+/// deduplication, so its peak memory usage is proportional to the input LTS.
+/// This version deduplicates incrementally with a compact set of outgoing
+/// transitions per source block and only emits new transitions into the
+/// builder, keeping peak memory proportional to the output LTS.
+pub fn quotient_lts_streaming<L: LTS>(
+    lts: &L,
+    partition: &impl Partition,
+    eliminate_tau_loops: bool,
+) -> LabelledTransitionSystem<L::Label> {
+    let mut builder = LtsBuilderFast::with_capacity(
+        lts.labels().into(),
+        Vec::new(),
+        partition.num_of_blocks(), // We expect one transition per state.
+    );
+
+    // The builder reorders the labels, so resolve their indices up front.
+    let label_map: Vec<LabelIndex> = lts.labels().iter().map(|label| builder.label_index(label)).collect();
+
+    // For every source block the set of (label, to block) pairs emitted so far.
+    let mut outgoing: Vec<VecSet<(LabelIndex, BlockIndex)>> = Vec::new();
+    outgoing.resize_with(partition.num_of_blocks(), VecSet::new);
+
+    for state_index in lts.iter_states() {
+        let block = partition.block_number(state_index);
+        debug_assert!(
+            block < partition.num_of_blocks(),
+            "Quotienting assumes that the block numbers do not exceed the number of blocks"
+        );
+
+        for transition in lts.outgoing_transitions(state_index) {
+            let to_block = partition.block_number(transition.to);
+
+            // If we eliminate tau loops then check if the 'to' and 'from' end up in the same block
+            if !(eliminate_tau_loops && lts.is_hidden_label(transition.label) && block == to_block) {
+                let label = label_map[transition.label.value()];
+
+                if outgoing[block.value()].insert((label, to_block)) {
+                    builder.add_transition_indexed(
+                        StateIndex::new(block.value()),
+                        label,
+                        StateIndex::new(to_block.value()),
+                    );
+                }
+            }
+        }
+    }
+
+    builder.require_num_of_states(partition.num_of_blocks());
+    builder.finish(
+        StateIndex::new(partition.block_number(lts.initial_state_index()).value()),
+        false,
+    )
+}
+
 /// Optimised implementation for block partitions.
 ///
 /// Chooses a single state in the block as representative. If BRANCHING then the chosen state is a bottom state.
@@ -136,3 +195,53 @@ pub fn quotient_lts_block<L: LTS, const BRANCHING: bool>(
         true,
     )
 }
+
+#[cfg(test)]
+mod tests {
+    use merc_lts::random_lts;
+    use merc_utilities::random_test;
+    use test_log::test;
+
+    use crate::tau_scc_decomposition;
+
+    use super::*;
+
+    /// Returns the transitions of the given LTS as sorted (from, label, to) triples.
+    fn sorted_transitions<L: LTS>(lts: &L) -> Vec<(StateIndex, usize, StateIndex)> {
+        let mut transitions: Vec<_> = lts
+            .iter_states()
+            .flat_map(|state_index| {
+                lts.outgoing_transitions(state_index)
+                    .map(move |transition| (state_index, transition.label.value(), transition.to))
+            })
+            .collect();
+        transitions.sort();
+        transitions
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_random_quotient_streaming() {
+        random_test(100, |rng| {
+            let lts = random_lts(rng, 10, 3, 3);
+            let partition = tau_scc_decomposition(&lts);
+
+            for eliminate_tau_loops in [false, true] {
+                let expected = quotient_lts_naive(&lts, &partition, eliminate_tau_loops);
+                let result = quotient_lts_streaming(&lts, &partition, eliminate_tau_loops);
+
+                assert_eq!(result.labels(), expected.labels(), "The labels should match");
+                assert_eq!(
+                    result.initial_state_index(),
+                    expected.initial_state_index(),
+                    "The initial state should match"
+                );
+                assert_eq!(
+                    sorted_transitions(&result),
+                    sorted_transitions(&expected),
+                    "The streaming quotient should yield the same transitions"
+                );
+            }
+        });
+    }
+}
@@ -1,15 +1,20 @@
 #![forbid(unsafe_code)]
 
+use log::warn;
+
 use merc_lts::LTS;
 use merc_lts::LabelledTransitionSystem;
 use merc_utilities::Timing;
 
 use crate::branching_bisim_sigref;
 use crate::branching_bisim_sigref_naive;
+use crate::branching_bisim_sigref_parallel;
 use crate::quotient_lts_block;
-use crate::quotient_lts_naive;
+use crate::quotient_lts_streaming;
 use crate::strong_bisim_sigref;
 use crate::strong_bisim_sigref_naive;
+use crate::strong_bisim_sigref_parallel;
+use crate::weak_bisim_sigref_lazy;
 use crate::weak_bisim_sigref_naive;
 use crate::weak_bisimulation;
 
@@ -20,6 +25,8 @@ pub enum Equivalence {
     WeakBisim,
     /// Various signature based reduction algorithms.
     WeakBisimSigref,
+    /// Signature based reduction with a lazy tau-reachability oracle.
+    WeakBisimSigrefLazy,
     StrongBisim,
     StrongBisimNaive,
     BranchingBisim,
@@ -32,12 +39,17 @@ pub fn reduce_lts<L: LTS>(lts: L, equivalence: Equivalence, timing: &mut Timing)
         Equivalence::WeakBisim => {
             let (lts, partition) = weak_bisimulation(lts, timing);
             let quotient_time = timing.start("quotient");
-            (quotient_lts_naive(&lts, &partition, true), quotient_time)
+            (quotient_lts_streaming(&lts, &partition, true), quotient_time)
         }
         Equivalence::WeakBisimSigref => {
             let (lts, partition) = weak_bisim_sigref_naive(lts, timing);
             let quotient_time = timing.start("quotient");
-            (quotient_lts_naive(&lts, &partition, true), quotient_time)
+            (quotient_lts_streaming(&lts, &partition, true), quotient_time)
+        }
+        Equivalence::WeakBisimSigrefLazy => {
+            let (lts, partition) = weak_bisim_sigref_lazy(lts, timing);
+            let quotient_time = timing.start("quotient");
+            (quotient_lts_streaming(&lts, &partition, true), quotient_time)
         }
         Equivalence::StrongBisim => {
             let (lts, partition) = strong_bisim_sigref(lts, timing);
@@ -47,7 +59,7 @@ pub fn reduce_lts<L: LTS>(lts: L, equivalence: Equivalence, timing: &mut Timing)
         Equivalence::StrongBisimNaive => {
             let (lts, partition) = strong_bisim_sigref_naive(lts, timing);
             let quotient_time = timing.start("quotient");
-            (quotient_lts_naive(&lts, &partition, false), quotient_time)
+            (quotient_lts_streaming(&lts, &partition, false), quotient_time)
         }
         Equivalence::BranchingBisim => {
             let (lts, partition) = branching_bisim_sigref(lts, timing);
@@ -57,10 +69,47 @@ pub fn reduce_lts<L: LTS>(lts: L, equivalence: Equivalence, timing: &mut Timing)
         Equivalence::BranchingBisimNaive => {
             let (lts, partition) = branching_bisim_sigref_naive(lts, timing);
             let quotient_time = timing.start("quotient");
-            (quotient_lts_naive(&lts, &partition, true), quotient_time)
+            (quotient_lts_streaming(&lts, &partition, true), quotient_time)
         }
     };
 
     timer.finish();
     result
 }
+
+/// Same as [reduce_lts], but uses the given number of worker threads for the
+/// equivalences that have a parallel implementation.
+///
+/// Falls back to the sequential algorithm when only one thread is requested or
+/// when the equivalence has no parallel implementation.
+pub fn reduce_lts_parallel<L: LTS + Sync>(
+    lts: L,
+    equivalence: Equivalence,
+    threads: usize,
+    timing: &mut Timing,
+) -> LabelledTransitionSystem<L::Label> {
+    if threads <= 1 {
+        return reduce_lts(lts, equivalence, timing);
+    }
+
+    match equivalence {
+        Equivalence::StrongBisim | Equivalence::StrongBisimNaive => {
+            let (lts, partition) = strong_bisim_sigref_parallel(lts, threads, timing);
+            let mut timer = timing.start("quotient");
+            let result = quotient_lts_streaming(&lts, &partition, false);
+            timer.finish();
+            result
+        }
+        Equivalence::BranchingBisim => {
+            let (lts, partition) = branching_bisim_sigref_parallel(lts, threads, timing);
+            let mut timer = timing.start("quotient");
+            let result = quotient_lts_block::<_, true>(&lts, &partition);
+            timer.finish();
+            result
+        }
+        _ => {
+            warn!("There is no parallel implementation for {equivalence:?}, using the sequential algorithm.");
+            reduce_lts(lts, equivalence, timing)
+        }
+    }
+}
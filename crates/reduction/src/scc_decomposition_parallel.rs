@@ -0,0 +1,400 @@
+#![forbid(unsafe_code)]
+
+use std::sync::atomic::AtomicUsize;
+use std::sync::atomic::Ordering;
+
+use log::debug;
+use rayon::Scope;
+use rayon::ThreadPoolBuilder;
+use rayon::iter::IntoParallelRefIterator;
+use rayon::iter::ParallelIterator;
+use rustc_hash::FxHashMap;
+
+use merc_io::LargeFormatter;
+use merc_lts::LTS;
+use merc_lts::LabelIndex;
+use merc_lts::StateIndex;
+use merc_lts::TransitionTable;
+
+use crate::BlockIndex;
+use crate::IndexedPartition;
+use crate::Partition;
+use crate::scc_decomposition;
+
+/// Computes the strongly connected tau component partitioning of the given LTS
+/// using the given number of worker threads.
+pub fn tau_scc_decomposition_parallel(lts: &(impl LTS + Sync), threads: usize) -> IndexedPartition {
+    scc_decomposition_parallel(lts, &|_, label_index, _| lts.is_hidden_label(label_index), threads)
+}
+
+/// Computes the strongly connected component partitioning of the given LTS
+/// using the given number of worker threads.
+///
+/// Implements the forward-backward algorithm with trimming. A region of states
+/// is first trimmed by peeling off states without incoming or outgoing edges
+/// within the region, which are trivial components. Then the states reachable
+/// forwards and backwards from a pivot are computed; their intersection is a
+/// component and the three remaining parts are independent subproblems that
+/// are processed concurrently. The components are numbered by their first
+/// state afterwards, so the resulting partition is independent of the number
+/// of threads. Note that [scc_decomposition] numbers the components in the
+/// order in which the depth first search completes them instead.
+pub fn scc_decomposition_parallel<L, F>(lts: &L, filter: &F, threads: usize) -> IndexedPartition
+where
+    L: LTS + Sync,
+    F: Fn(StateIndex, LabelIndex, StateIndex) -> bool + Sync,
+{
+    if threads <= 1 {
+        return scc_decomposition(lts, filter);
+    }
+
+    let pool = ThreadPoolBuilder::new()
+        .num_threads(threads)
+        .build()
+        .expect("Failed to construct the worker thread pool");
+
+    let incoming = TransitionTable::new(lts);
+
+    let decomposition = FwbwDecomposition {
+        lts,
+        filter,
+        incoming: &incoming,
+        region: (0..lts.num_of_states()).map(|_| AtomicUsize::new(0)).collect(),
+        forward_mark: (0..lts.num_of_states()).map(|_| AtomicUsize::new(DONE)).collect(),
+        backward_mark: (0..lts.num_of_states()).map(|_| AtomicUsize::new(DONE)).collect(),
+        component: (0..lts.num_of_states()).map(|_| AtomicUsize::new(DONE)).collect(),
+        next_component: AtomicUsize::new(0),
+        next_region: AtomicUsize::new(1),
+    };
+
+    pool.install(|| {
+        rayon::scope(|scope| {
+            decomposition.process_region(scope, lts.iter_states().collect(), 0);
+        })
+    });
+
+    // Renumber the components in order of their first state, so that the
+    // partition does not depend on the interleaving of the worker threads.
+    let mut partition = IndexedPartition::new(lts.num_of_states());
+    let mut renumber: FxHashMap<usize, BlockIndex> = FxHashMap::default();
+
+    for state_index in lts.iter_states() {
+        let component = decomposition.component[state_index].load(Ordering::Relaxed);
+        let next_block = BlockIndex::new(renumber.len());
+        partition.set_block(state_index, *renumber.entry(component).or_insert(next_block));
+    }
+
+    debug!(
+        "Found {} strongly connected components",
+        LargeFormatter(partition.num_of_blocks())
+    );
+    partition
+}
+
+/// The region of states that have been assigned to a component.
+const DONE: usize = usize::MAX;
+
+/// Parts below this size are processed on the current worker instead of being
+/// spawned as a separate task.
+const SPAWN_THRESHOLD: usize = 256;
+
+/// Search frontiers below this size are expanded sequentially.
+const PARALLEL_FRONTIER: usize = 256;
+
+/// The shared state of the forward-backward decomposition.
+///
+/// Every state carries the region it currently belongs to. The regions are
+/// disjoint and every region is owned by exactly one task, so only the owning
+/// task writes the entries of its states while concurrent searches of other
+/// regions merely read them. The region numbers are never reused, which allows
+/// the search marks to double as visited flags: a state was reached by the
+/// current search iff its mark equals the current region.
+struct FwbwDecomposition<'a, L, F> {
+    lts: &'a L,
+    filter: &'a F,
+    incoming: &'a TransitionTable,
+
+    /// The region every state belongs to, or [DONE] once it has a component.
+    region: Vec<AtomicUsize>,
+    /// The region that most recently reached this state forwards.
+    forward_mark: Vec<AtomicUsize>,
+    /// The region that most recently reached this state backwards.
+    backward_mark: Vec<AtomicUsize>,
+    /// The component of every state, under a temporary numbering.
+    component: Vec<AtomicUsize>,
+
+    next_component: AtomicUsize,
+    next_region: AtomicUsize,
+}
+
+impl<'a, L, F> FwbwDecomposition<'a, L, F>
+where
+    L: LTS + Sync,
+    F: Fn(StateIndex, LabelIndex, StateIndex) -> bool + Sync,
+{
+    /// Decomposes the given region into strongly connected components.
+    ///
+    /// Loops on the largest remaining part and recurses on the two smaller
+    /// ones, so the recursion depth is logarithmic in the region size.
+    fn process_region<'s>(&'s self, scope: &Scope<'s>, mut states: Vec<StateIndex>, mut region: usize) {
+        loop {
+            if states.len() <= 1 {
+                if let Some(&state) = states.first() {
+                    self.assign_component(state);
+                }
+                return;
+            }
+
+            self.trim(region, &mut states);
+            if states.len() <= 1 {
+                if let Some(&state) = states.first() {
+                    self.assign_component(state);
+                }
+                return;
+            }
+
+            // The states reachable forwards and backwards from the pivot; the
+            // intersection is exactly the component of the pivot.
+            let pivot = states[0];
+            self.search(region, pivot, true);
+            self.search(region, pivot, false);
+
+            let component = self.next_component.fetch_add(1, Ordering::Relaxed);
+            let first_region = self.next_region.fetch_add(3, Ordering::Relaxed);
+
+            let mut forward_part = Vec::new();
+            let mut backward_part = Vec::new();
+            let mut remainder_part = Vec::new();
+
+            for &state in &states {
+                let forward = self.forward_mark[state].load(Ordering::Relaxed) == region;
+                let backward = self.backward_mark[state].load(Ordering::Relaxed) == region;
+
+                match (forward, backward) {
+                    (true, true) => {
+                        self.component[state].store(component, Ordering::Relaxed);
+                        self.region[state].store(DONE, Ordering::Relaxed);
+                    }
+                    (true, false) => {
+                        self.region[state].store(first_region, Ordering::Relaxed);
+                        forward_part.push(state);
+                    }
+                    (false, true) => {
+                        self.region[state].store(first_region + 1, Ordering::Relaxed);
+                        backward_part.push(state);
+                    }
+                    (false, false) => {
+                        self.region[state].store(first_region + 2, Ordering::Relaxed);
+                        remainder_part.push(state);
+                    }
+                }
+            }
+
+            // Continue with the largest part and hand off the smaller ones.
+            let mut parts = [
+                (forward_part, first_region),
+                (backward_part, first_region + 1),
+                (remainder_part, first_region + 2),
+            ];
+            parts.sort_by_key(|(part, _)| part.len());
+            let [second, third, largest] = parts;
+
+            for (part, part_region) in [second, third] {
+                if part.is_empty() {
+                    continue;
+                }
+
+                if part.len() >= SPAWN_THRESHOLD {
+                    scope.spawn(move |scope| self.process_region(scope, part, part_region));
+                } else {
+                    self.process_region(scope, part, part_region);
+                }
+            }
+
+            (states, region) = largest;
+        }
+    }
+
+    /// Assigns the given state to a fresh trivial component.
+    fn assign_component(&self, state: StateIndex) {
+        self.component[state].store(self.next_component.fetch_add(1, Ordering::Relaxed), Ordering::Relaxed);
+        self.region[state].store(DONE, Ordering::Relaxed);
+    }
+
+    /// Peels off the states without incoming or outgoing edges within the
+    /// region, which are trivial components, until none remain. A single pass
+    /// eliminates entire acyclic parts of the region, so a tau-free or
+    /// chain-like region never reaches the searches below.
+    fn trim(&self, region: usize, states: &mut Vec<StateIndex>) {
+        let mut indegree: FxHashMap<StateIndex, usize> = FxHashMap::default();
+        let mut outdegree: FxHashMap<StateIndex, usize> = FxHashMap::default();
+
+        for &state in states.iter() {
+            self.for_each_neighbour(state, region, true, |successor| {
+                *outdegree.entry(state).or_insert(0) += 1;
+                *indegree.entry(successor).or_insert(0) += 1;
+            });
+        }
+
+        // A self-loop contributes to both degrees, so a state on a self-loop
+        // is correctly kept as a cycle for the searches.
+        let mut worklist: Vec<StateIndex> = states
+            .iter()
+            .copied()
+            .filter(|state| {
+                indegree.get(state).copied().unwrap_or(0) == 0 || outdegree.get(state).copied().unwrap_or(0) == 0
+            })
+            .collect();
+
+        for &state in &worklist {
+            self.assign_component(state);
+        }
+
+        while let Some(state) = worklist.pop() {
+            self.for_each_neighbour(state, region, true, |successor| {
+                let degree = indegree.get_mut(&successor).expect("The degree was counted above");
+                *degree -= 1;
+
+                if *degree == 0 || outdegree.get(&successor).copied().unwrap_or(0) == 0 {
+                    self.assign_component(successor);
+                    worklist.push(successor);
+                }
+            });
+
+            self.for_each_neighbour(state, region, false, |predecessor| {
+                let degree = outdegree.get_mut(&predecessor).expect("The degree was counted above");
+                *degree -= 1;
+
+                if *degree == 0 || indegree.get(&predecessor).copied().unwrap_or(0) == 0 {
+                    self.assign_component(predecessor);
+                    worklist.push(predecessor);
+                }
+            });
+        }
+
+        states.retain(|&state| self.region[state].load(Ordering::Relaxed) == region);
+    }
+
+    /// Marks the states of the region reachable from the pivot with the region
+    /// number, following the edges forwards or backwards. Large frontiers are
+    /// expanded in parallel; a state is claimed by swapping in the region
+    /// number, so it enters the next frontier exactly once.
+    fn search(&self, region: usize, pivot: StateIndex, forward: bool) {
+        let marks = if forward {
+            &self.forward_mark
+        } else {
+            &self.backward_mark
+        };
+        marks[pivot].store(region, Ordering::Relaxed);
+
+        let mut frontier = vec![pivot];
+        while !frontier.is_empty() {
+            frontier = if frontier.len() >= PARALLEL_FRONTIER {
+                frontier
+                    .par_iter()
+                    .flat_map_iter(|&state| {
+                        let mut successors = Vec::new();
+                        self.for_each_neighbour(state, region, forward, |successor| successors.push(successor));
+                        successors.into_iter()
+                    })
+                    .filter(|&successor| marks[successor].swap(region, Ordering::Relaxed) != region)
+                    .collect()
+            } else {
+                let mut next = Vec::new();
+                for &state in &frontier {
+                    self.for_each_neighbour(state, region, forward, |successor| {
+                        if marks[successor].swap(region, Ordering::Relaxed) != region {
+                            next.push(successor);
+                        }
+                    });
+                }
+                next
+            };
+        }
+    }
+
+    /// Calls the given function for every neighbour of the state that passes
+    /// the filter and belongs to the region, following the edges forwards or
+    /// backwards.
+    fn for_each_neighbour(&self, state: StateIndex, region: usize, forward: bool, mut found: impl FnMut(StateIndex)) {
+        if forward {
+            for transition in self.lts.outgoing_transitions(state) {
+                if (self.filter)(state, transition.label, transition.to)
+                    && self.region[transition.to].load(Ordering::Relaxed) == region
+                {
+                    found(transition.to);
+                }
+            }
+        } else {
+            // The incoming transitions store the source state in the to field.
+            for transition in self.incoming.incoming_transitions(state) {
+                if (self.filter)(transition.to, transition.label, state)
+                    && self.region[transition.to].load(Ordering::Relaxed) == region
+                {
+                    found(transition.to);
+                }
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use merc_lts::random_lts;
+    use merc_utilities::random_test;
+    use test_log::test;
+
+    use crate::Partition;
+    use crate::tau_scc_decomposition;
+
+    use super::*;
+
+    /// Asserts that both partitions have the same blocks up to renumbering.
+    fn assert_same_partition(lts: &impl LTS, partition: &IndexedPartition, expected: &IndexedPartition) {
+        assert_eq!(
+            partition.num_of_blocks(),
+            expected.num_of_blocks(),
+            "Both partitions should have the same number of blocks"
+        );
+
+        let mut renumber: FxHashMap<BlockIndex, BlockIndex> = FxHashMap::default();
+        for state_index in lts.iter_states() {
+            let expected_block = *renumber
+                .entry(partition.block_number(state_index))
+                .or_insert_with(|| expected.block_number(state_index));
+
+            assert_eq!(
+                expected.block_number(state_index),
+                expected_block,
+                "The parallel partition should be equal to the sequential partition up to renumbering"
+            );
+        }
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_random_tau_scc_decomposition_parallel() {
+        random_test(100, |rng| {
+            let lts = random_lts(rng, 10, 3, 3);
+
+            let expected = tau_scc_decomposition(&lts);
+            let partition = tau_scc_decomposition_parallel(&lts, 4);
+
+            assert_same_partition(&lts, &partition, &expected);
+        });
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Miri is too slow
+    fn test_random_tau_scc_decomposition_parallel_large() {
+        random_test(10, |rng| {
+            // Large enough to exercise the spawned tasks and parallel frontiers.
+            let lts = random_lts(rng, 2000, 3, 3);
+
+            let expected = tau_scc_decomposition(&lts);
+            let partition = tau_scc_decomposition_parallel(&lts, 4);
+
+            assert_same_partition(&lts, &partition, &expected);
+        });
+    }
+}
@@ -5,7 +5,7 @@ use log::debug;
 use log::info;
 use log::trace;
 use merc_io::TimeProgress;
-use merc_lts::IncomingTransitions;
+use merc_lts::TransitionTable;
 use merc_lts::LTS;
 use merc_lts::LabelIndex;
 use merc_lts::LabelledTransitionSystem;
@@ -22,11 +22,14 @@ use crate::IndexedPartition;
 use crate::Partition;
 use crate::Signature;
 use crate::SignatureBuilder;
+use crate::SignatureTable;
+use crate::TauReachabilityOracle;
 use crate::branching_bisim_signature;
 use crate::branching_bisim_signature_inductive;
 use crate::branching_bisim_signature_sorted;
 use crate::is_tau_hat;
 use crate::preprocess_branching;
+use crate::preprocess_branching_parallel;
 use crate::strong_bisim_signature;
 use crate::weak_bisim_signature_sorted;
 use crate::weak_bisim_signature_sorted_taus;
@@ -34,7 +37,7 @@ use crate::weak_bisim_signature_sorted_taus;
 /// Computes a strong bisimulation partitioning using signature refinement
 pub fn strong_bisim_sigref<L: LTS>(lts: L, timing: &mut Timing) -> (L, BlockPartition) {
     let mut timepre = timing.start("preprocess");
-    let incoming = IncomingTransitions::new(&lts);
+    let incoming = TransitionTable::new(&lts);
     timepre.finish();
 
     let mut time = timing.start("reduction");
@@ -69,25 +72,56 @@ pub fn branching_bisim_sigref<L: LTS>(
 ) -> (LabelledTransitionSystem<L::Label>, BlockPartition) {
     let mut timepre = timing.start("preprocess");
     let preprocessed_lts = preprocess_branching(lts);
-    let incoming = IncomingTransitions::new(&preprocessed_lts);
+    let incoming = TransitionTable::new(&preprocessed_lts);
     timepre.finish();
 
     let mut time = timing.start("reduction");
+    let partition = branching_bisim_refine(&preprocessed_lts, &incoming);
+    time.finish();
+
+    // Combine the SCC partition with the branching bisimulation partition.
+    (preprocessed_lts, partition)
+}
+
+/// Same as [branching_bisim_sigref], but performs the tau SCC preprocessing
+/// with the given number of worker threads. The refinement itself is
+/// sequential.
+pub fn branching_bisim_sigref_parallel<L: LTS + Sync>(
+    lts: L,
+    threads: usize,
+    timing: &mut Timing,
+) -> (LabelledTransitionSystem<L::Label>, BlockPartition) {
+    let mut timepre = timing.start("preprocess");
+    let preprocessed_lts = preprocess_branching_parallel(lts, threads);
+    let incoming = TransitionTable::new(&preprocessed_lts);
+    timepre.finish();
+
+    let mut time = timing.start("reduction");
+    let partition = branching_bisim_refine(&preprocessed_lts, &incoming);
+    time.finish();
+
+    // Combine the SCC partition with the branching bisimulation partition.
+    (preprocessed_lts, partition)
+}
+
+/// The signature refinement shared by the branching bisimulation variants,
+/// applied to a preprocessed LTS without tau-loops.
+fn branching_bisim_refine<L: LTS>(preprocessed_lts: &L, incoming: &TransitionTable) -> BlockPartition {
     let mut expected_builder = SignatureBuilder::default();
     let mut visited = FxHashSet::default();
     let mut stack = Vec::new();
 
-    let partition = signature_refinement::<_, _, true>(
-        &preprocessed_lts,
-        &incoming,
+    signature_refinement::<_, _, true>(
+        preprocessed_lts,
+        incoming,
         |state_index, partition, state_to_key, builder| {
-            branching_bisim_signature_inductive(state_index, &preprocessed_lts, partition, state_to_key, builder);
+            branching_bisim_signature_inductive(state_index, preprocessed_lts, partition, state_to_key, builder);
 
             // Compute the expected signature, only used in debugging.
             if cfg!(debug_assertions) {
                 branching_bisim_signature(
                     state_index,
-                    &preprocessed_lts,
+                    preprocessed_lts,
                     partition,
                     &mut expected_builder,
                     &mut visited,
@@ -106,25 +140,20 @@ pub fn branching_bisim_sigref<L: LTS>(
         |signature, key_to_signature| {
             // Inductive signatures.
             for (label, key) in signature.iter().rev() {
-                if is_tau_hat(*label, &preprocessed_lts)
+                if is_tau_hat(*label, preprocessed_lts)
                     && key_to_signature[*key].is_subset_of(signature, (*label, *key))
                 {
                     return Some(*key);
                 }
 
-                if !is_tau_hat(*label, &preprocessed_lts) {
+                if !is_tau_hat(*label, preprocessed_lts) {
                     return None;
                 }
             }
 
             None
         },
-    );
-
-    time.finish();
-
-    // Combine the SCC partition with the branching bisimulation partition.
-    (preprocessed_lts, partition)
+    )
 }
 
 /// Computes a branching bisimulation partitioning using signature refinement without dirty blocks.
@@ -194,6 +223,103 @@ pub fn weak_bisim_sigref_naive<L: LTS>(
     (preprocessed_lts, partition)
 }
 
+/// Computes a weak bisimulation partitioning using signature refinement with a
+/// lazy tau-reachability oracle.
+///
+/// Computes the same partition as [weak_bisim_sigref_naive], but instead of
+/// materializing the per-state tau signatures in every round the signatures
+/// are answered by a [TauReachabilityOracle]. Blocks keep their number when
+/// they are split, so between rounds only the states whose tau-closure
+/// crosses a split block have their signatures recomputed.
+pub fn weak_bisim_sigref_lazy<L: LTS>(
+    lts: L,
+    timing: &mut Timing,
+) -> (LabelledTransitionSystem<L::Label>, IndexedPartition) {
+    let mut timepre = timing.start("preprocess");
+    let preprocessed_lts = preprocess_branching(lts);
+    timepre.finish();
+
+    let mut time = timing.start("reduction");
+
+    let mut partition = IndexedPartition::new(preprocessed_lts.num_of_states());
+    let mut next_partition = IndexedPartition::new(preprocessed_lts.num_of_states());
+    let mut oracle = TauReachabilityOracle::new(preprocessed_lts.num_of_states());
+
+    // Maps the (block, signature) pairs of a round to their new block number.
+    let mut block_of: FxHashMap<(BlockIndex, SignatureBuilder), BlockIndex> = FxHashMap::default();
+    // The number of distinct signatures seen per block in a round.
+    let mut groups: Vec<usize> = Vec::new();
+    let mut split_blocks: Vec<BlockIndex> = Vec::new();
+
+    let progress = TimeProgress::new(
+        |(iteration, blocks)| {
+            debug!("Iteration {iteration}, found {blocks} blocks...",);
+        },
+        5,
+    );
+
+    let mut iteration = 0;
+    loop {
+        progress.print((iteration, partition.num_of_blocks()));
+
+        block_of.clear();
+        split_blocks.clear();
+        groups.clear();
+        groups.resize(partition.num_of_blocks(), 0);
+
+        let mut next_block = partition.num_of_blocks();
+        for state_index in preprocessed_lts.iter_states() {
+            let block_index = partition.block_number(state_index);
+            let signature = oracle.signature(state_index, &preprocessed_lts, &partition);
+            let key = (block_index, signature.to_vec());
+
+            // The first signature of a block keeps the block number and the
+            // other signatures are assigned fresh numbers, so the numbers of
+            // unsplit blocks are stable between rounds.
+            let new_block = match block_of.get(&key) {
+                Some(&new_block) => new_block,
+                None => {
+                    groups[block_index] += 1;
+                    let new_block = if groups[block_index] == 1 {
+                        block_index
+                    } else {
+                        if groups[block_index] == 2 {
+                            split_blocks.push(block_index);
+                        }
+
+                        let new_block = BlockIndex::new(next_block);
+                        next_block += 1;
+                        new_block
+                    };
+
+                    block_of.insert(key, new_block);
+                    new_block
+                }
+            };
+
+            next_partition.set_block(state_index, new_block);
+        }
+
+        if split_blocks.is_empty() {
+            break;
+        }
+
+        oracle.split_blocks(&split_blocks, next_block);
+        swap(&mut partition, &mut next_partition);
+        iteration += 1;
+
+        debug_assert!(
+            iteration <= preprocessed_lts.num_of_states().max(2),
+            "There can never be more splits than number of states, but at least two iterations for stability"
+        );
+    }
+
+    oracle.print_metrics(preprocessed_lts.num_of_states(), iteration);
+    time.finish();
+
+    (preprocessed_lts, partition)
+}
+
 /// General signature refinement algorithm that accepts an arbitrary signature
 ///
 /// The signature function is called for each state and should fill the
@@ -201,7 +327,7 @@ pub fn weak_bisim_sigref_naive<L: LTS>(
 /// current partition, the signatures per state for the next partition.
 fn signature_refinement<F, G, const BRANCHING: bool>(
     lts: &impl LTS,
-    incoming: &IncomingTransitions,
+    incoming: &TransitionTable,
     mut signature: F,
     mut renumber: G,
 ) -> BlockPartition
@@ -214,8 +340,8 @@ where
     let mut builder = SignatureBuilder::default();
     let mut split_builder = BlockPartitionBuilder::default();
 
-    // Put all the states in the initial partition { S }.
-    let mut id: FxHashMap<Signature<'_>, BlockIndex> = FxHashMap::default();
+    // Deduplicates the signatures of the current blocks.
+    let mut id = SignatureTable::default();
 
     // Assigns the signature to each state.
     let mut partition = BlockPartition::new(lts.num_of_states());
@@ -245,7 +371,6 @@ where
         key_to_signature.clear();
 
         // Safety: The current signatures have been removed, so it safe to reuse the memory.
-        let id: &'_ mut FxHashMap<Signature<'_>, BlockIndex> = unsafe { std::mem::transmute(&mut id) };
         let key_to_signature: &'_ mut Vec<Signature<'_>> = unsafe { std::mem::transmute(&mut key_to_signature) };
 
         arena.reset();
@@ -273,19 +398,23 @@ where
                 // Compute the signature of a single state
                 let index = if let Some(key) = renumber(&builder, key_to_signature) {
                     key
-                } else if let Some((_, index)) = id.get_key_value(&Signature::new(&builder)) {
-                    *index
                 } else {
-                    let slice = if builder.is_empty() {
-                        empty_slice
-                    } else {
-                        arena.alloc_slice_copy(&builder)
-                    };
+                    let hash = id.hash(&builder);
                     let number = BlockIndex::new(key_to_signature.len());
-                    id.insert(Signature::new(slice), number);
-                    key_to_signature.push(Signature::new(slice));
+                    let (index, inserted) = id.find_or_insert(hash, &builder, number, |key| {
+                        key_to_signature[key.value()].as_slice()
+                    });
+
+                    if inserted {
+                        let slice = if builder.is_empty() {
+                            empty_slice
+                        } else {
+                            arena.alloc_slice_copy(&builder)
+                        };
+                        key_to_signature.push(Signature::new(slice));
+                    }
 
-                    number
+                    index
                 };
 
                 // (branching) Keep track of the signature for every block in the next partition.
@@ -356,8 +485,9 @@ where
     let mut arena = Bump::new();
     let mut builder = SignatureBuilder::default();
 
-    // Put all the states in the initial partition { S }.
-    let mut id: FxHashMap<Signature<'_>, BlockIndex> = FxHashMap::default();
+    // Deduplicates the signatures of the current blocks.
+    let mut id = SignatureTable::default();
+    let mut key_to_signature: Vec<Signature<'_>> = Vec::new();
 
     // Assigns the signature to each state.
     let mut partition = IndexedPartition::new(lts.num_of_states());
@@ -386,12 +516,13 @@ where
 
         // Clear the current partition to start the next blocks.
         id.clear();
+        key_to_signature.clear();
 
         state_to_signature.clear();
         state_to_signature.resize_with(lts.num_of_states(), Signature::default);
 
         // Safety: The current signatures have been removed, so it safe to reuse the memory.
-        let id: &'_ mut FxHashMap<Signature<'_>, BlockIndex> = unsafe { std::mem::transmute(&mut id) };
+        let key_to_signature: &'_ mut Vec<Signature<'_>> = unsafe { std::mem::transmute(&mut key_to_signature) };
         let state_to_signature: &mut Vec<Signature<'_>> = unsafe { std::mem::transmute(&mut state_to_signature) };
 
         // Remove the current signatures.
@@ -420,23 +551,31 @@ where
             trace!("State {state_index} signature {builder:?}");
 
             // Keep track of the index for every state, either use the arena to allocate space or simply borrow the value.
-            let mut new_id = BlockIndex::new(id.len());
-            if let Some((signature, index)) = id.get_key_value(&Signature::new(&builder)) {
-                // SAFETY: We know that the signature lives as long as the arena
-                state_to_signature[state_index] = unsafe {
-                    std::mem::transmute::<Signature<'_>, Signature<'_>>(Signature::new(signature.as_slice()))
-                };
-                new_id = *index;
-            } else {
+            let hash = id.hash(&builder);
+            let (new_id, inserted) = id.find_or_insert(
+                hash,
+                &builder,
+                BlockIndex::new(key_to_signature.len()),
+                |key| key_to_signature[key.value()].as_slice(),
+            );
+
+            if inserted {
                 let slice = if builder.is_empty() {
                     empty_slice
                 } else {
                     arena.alloc_slice_copy(&builder)
                 };
-                id.insert(Signature::new(slice), new_id);
+                key_to_signature.push(Signature::new(slice));
 
                 // (branching) Keep track of the signature for every block in the next partition.
                 state_to_signature[state_index] = Signature::new(slice);
+            } else {
+                // SAFETY: We know that the signature lives as long as the arena
+                state_to_signature[state_index] = unsafe {
+                    std::mem::transmute::<Signature<'_>, Signature<'_>>(Signature::new(
+                        key_to_signature[new_id.value()].as_slice(),
+                    ))
+                };
             }
 
             next_partition.set_block(state_index, new_id);
@@ -640,4 +779,19 @@ mod tests {
             is_refinement(&preprocessed_lts, &strong_partition, &weak_partition);
         });
     }
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Miri is too slow
+    fn test_random_weak_bisim_sigref_lazy() {
+        random_test(100, |rng| {
+            let lts = random_lts(rng, 10, 3, 3);
+            let mut timing = Timing::new();
+
+            let (_result_lts, result_partition) = weak_bisim_sigref_lazy(lts.clone(), &mut timing);
+            let (_expected_lts, expected_partition) = weak_bisim_sigref_naive(lts, &mut timing);
+
+            // Both preprocess the LTS in the same deterministic way.
+            assert!(equal_partitions(&result_partition, &expected_partition));
+        });
+    }
 }
@@ -0,0 +1,231 @@
+use std::mem::swap;
+
+use log::info;
+use rayon::ThreadPoolBuilder;
+use rayon::iter::IntoParallelIterator;
+use rayon::iter::ParallelIterator;
+
+use merc_io::TimeProgress;
+use merc_lts::LTS;
+use merc_lts::LabelIndex;
+use merc_lts::StateIndex;
+use merc_utilities::Timing;
+
+use crate::BlockIndex;
+use crate::IndexedPartition;
+use crate::SignatureBuilder;
+use crate::SignatureTable;
+use crate::is_valid_refinement;
+use crate::strong_bisim_signature;
+
+/// Computes a strong bisimulation partitioning using parallel signature refinement
+///
+/// Performs the same rounds as [crate::strong_bisim_sigref_naive], but computes
+/// the per-state signatures of a round on the given number of worker threads.
+/// This is safe since within a round every state only reads the transitions and
+/// the current partition. The states are split into chunks that are distributed
+/// over the workers by work stealing, and the per-chunk signature tables are
+/// merged between rounds. The merge processes the chunks in state order, so the
+/// resulting block numbers are independent of the number of threads.
+pub fn strong_bisim_sigref_parallel<L>(lts: L, threads: usize, timing: &mut Timing) -> (L, IndexedPartition)
+where
+    L: LTS + Sync,
+{
+    let pool = ThreadPoolBuilder::new()
+        .num_threads(threads)
+        .build()
+        .expect("Failed to construct the worker thread pool");
+
+    let mut time = timing.start("reduction");
+
+    // Deduplicates the signatures of the current blocks between rounds.
+    let mut id = SignatureTable::default();
+
+    // Assigns the signature to each state.
+    let mut partition = IndexedPartition::new(lts.num_of_states());
+    let mut next_partition = IndexedPartition::new(lts.num_of_states());
+
+    // Several chunks per worker such that work stealing can balance the load.
+    let chunk_size = lts.num_of_states().div_ceil(4 * threads.max(1)).max(1);
+
+    // Refine partitions until stable.
+    let mut old_count = 1;
+    let mut iteration = 0;
+
+    let progress = TimeProgress::new(
+        |(iteration, blocks)| {
+            info!("Iteration {iteration}, found {blocks} blocks...");
+        },
+        5,
+    );
+
+    while old_count != id.len() {
+        old_count = id.len();
+        progress.print((iteration, old_count));
+        swap(&mut partition, &mut next_partition);
+
+        // Compute the signatures of every chunk of states in parallel.
+        let chunks: Vec<ChunkSignatures> = pool.install(|| {
+            (0..lts.num_of_states())
+                .step_by(chunk_size)
+                .collect::<Vec<_>>()
+                .into_par_iter()
+                .map(|first_state| {
+                    let end = (first_state + chunk_size).min(lts.num_of_states());
+                    compute_chunk_signatures(&lts, &partition, first_state, end)
+                })
+                .collect()
+        });
+
+        // Merge the per-chunk signature tables, renumbering the local keys.
+        id.clear();
+
+        let mut key_to_signature: Vec<&[(LabelIndex, BlockIndex)]> = Vec::new();
+        let mut local_to_global: Vec<BlockIndex> = Vec::new();
+
+        for chunk in &chunks {
+            local_to_global.clear();
+
+            for local_key in 0..chunk.num_of_keys() {
+                let signature = chunk.signature(local_key);
+                let hash = id.hash(signature);
+                let (global_key, inserted) =
+                    id.find_or_insert(hash, signature, BlockIndex::new(key_to_signature.len()), |key| {
+                        key_to_signature[key.value()]
+                    });
+
+                if inserted {
+                    key_to_signature.push(signature);
+                }
+
+                local_to_global.push(global_key);
+            }
+
+            for (offset, &local_key) in chunk.state_to_key.iter().enumerate() {
+                next_partition.set_block(
+                    StateIndex::new(chunk.first_state + offset),
+                    local_to_global[local_key],
+                );
+            }
+        }
+
+        iteration += 1;
+
+        debug_assert!(
+            iteration <= lts.num_of_states().max(2),
+            "There can never be more splits than number of states, but at least two iterations for stability"
+        );
+    }
+
+    time.finish();
+
+    debug_assert!(
+        is_valid_refinement(&lts, &partition, |state_index, partition, builder| {
+            strong_bisim_signature(state_index, &lts, partition, builder)
+        }),
+        "The resulting partition is not a valid partition."
+    );
+
+    (lts, partition)
+}
+
+/// The signatures of a contiguous chunk of states, deduplicated within the chunk.
+struct ChunkSignatures {
+    /// The index of the first state in the chunk.
+    first_state: usize,
+
+    /// The local signature key of every state in the chunk.
+    state_to_key: Vec<usize>,
+
+    /// The signature pairs of all local keys, indexed by [ChunkSignatures::offsets].
+    data: Vec<(LabelIndex, BlockIndex)>,
+
+    /// The begin offset into the data for every local key, plus a final end offset.
+    offsets: Vec<usize>,
+}
+
+impl ChunkSignatures {
+    /// Returns the number of distinct signatures in the chunk.
+    fn num_of_keys(&self) -> usize {
+        self.offsets.len() - 1
+    }
+
+    /// Returns the signature of the given local key.
+    fn signature(&self, local_key: usize) -> &[(LabelIndex, BlockIndex)] {
+        &self.data[self.offsets[local_key]..self.offsets[local_key + 1]]
+    }
+}
+
+/// Computes the signatures of the states in the range [begin, end) and assigns
+/// them local keys in order of first occurrence.
+fn compute_chunk_signatures(
+    lts: &impl LTS,
+    partition: &IndexedPartition,
+    begin: usize,
+    end: usize,
+) -> ChunkSignatures {
+    let mut builder = SignatureBuilder::default();
+    let mut table = SignatureTable::with_capacity(2 * (end - begin));
+
+    let mut chunk = ChunkSignatures {
+        first_state: begin,
+        state_to_key: Vec::with_capacity(end - begin),
+        data: Vec::new(),
+        offsets: vec![0],
+    };
+
+    for state_index in (begin..end).map(StateIndex::new) {
+        strong_bisim_signature(state_index, lts, partition, &mut builder);
+
+        let hash = table.hash(&builder);
+        let (local_key, inserted) =
+            table.find_or_insert(hash, &builder, BlockIndex::new(chunk.num_of_keys()), |key| {
+                chunk.signature(key.value())
+            });
+
+        if inserted {
+            chunk.data.extend_from_slice(&builder);
+            chunk.offsets.push(chunk.data.len());
+        }
+
+        chunk.state_to_key.push(local_key.value());
+    }
+
+    chunk
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    use test_log::test;
+
+    use merc_lts::random_lts;
+    use merc_utilities::Timing;
+    use merc_utilities::random_test;
+
+    use crate::Partition;
+    use crate::strong_bisim_sigref_naive;
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Miri is too slow
+    fn test_random_strong_bisim_sigref_parallel() {
+        random_test(100, |rng| {
+            let lts = random_lts(rng, 10, 3, 3);
+            let mut timing = Timing::new();
+
+            let (_expected_lts, expected_partition) = strong_bisim_sigref_naive(lts.clone(), &mut timing);
+            let (lts, partition) = strong_bisim_sigref_parallel(lts, 4, &mut timing);
+
+            // The merge assigns block numbers in state order, so the partition
+            // matches the sequential one exactly.
+            for state_index in lts.iter_states() {
+                assert_eq!(
+                    partition.block_number(state_index),
+                    expected_partition.block_number(state_index),
+                    "The parallel partition should be equal to the sequential partition"
+                );
+            }
+        });
+    }
+}
@@ -0,0 +1,174 @@
+#![forbid(unsafe_code)]
+
+use ahash::RandomState;
+
+use merc_lts::LabelIndex;
+
+use crate::BlockIndex;
+
+/// A dedicated open addressing hash table that deduplicates signatures and
+/// assigns them consecutive block numbers.
+///
+/// The signature slices themselves live in the arena of the caller; the table
+/// only stores the hash and the assigned block number of every signature, and
+/// resolves collisions through a lookup function provided by the caller. This
+/// avoids the overhead of a generic hash map with signature keys: growing the
+/// table never rehashes signatures since the hash is stored, and the table can
+/// be reused across refinement rounds without reallocation.
+pub struct SignatureTable {
+    hash_builder: RandomState,
+
+    /// Slots of (hash, block number); [EMPTY] indicates an unused slot.
+    slots: Vec<(u64, usize)>,
+
+    /// The number of occupied slots.
+    len: usize,
+}
+
+/// The block number used to indicate an empty slot.
+const EMPTY: usize = usize::MAX;
+
+impl Default for SignatureTable {
+    fn default() -> Self {
+        SignatureTable::with_capacity(1024)
+    }
+}
+
+impl SignatureTable {
+    /// Creates a table with space for at least the given number of signatures.
+    pub fn with_capacity(capacity: usize) -> Self {
+        Self {
+            hash_builder: RandomState::new(),
+            slots: vec![(0, EMPTY); capacity.next_power_of_two()],
+            len: 0,
+        }
+    }
+
+    /// Returns the number of signatures in the table.
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Returns true iff the table contains no signatures.
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Removes all signatures from the table, keeping the allocated capacity.
+    pub fn clear(&mut self) {
+        self.slots.fill((0, EMPTY));
+        self.len = 0;
+    }
+
+    /// Computes the hash of the given signature, using an AES based hash over
+    /// the signature pairs.
+    pub fn hash(&self, signature: &[(LabelIndex, BlockIndex)]) -> u64 {
+        self.hash_builder.hash_one(signature)
+    }
+
+    /// Returns the block number assigned to the given signature, or assigns it
+    /// the given block number when the signature is new. The boolean indicates
+    /// whether the signature was inserted.
+    ///
+    /// The hash must be computed with [SignatureTable::hash] and the lookup
+    /// function must return the signature stored for an assigned block number.
+    pub fn find_or_insert<'a, F>(
+        &mut self,
+        hash: u64,
+        signature: &[(LabelIndex, BlockIndex)],
+        block: BlockIndex,
+        lookup: F,
+    ) -> (BlockIndex, bool)
+    where
+        F: Fn(BlockIndex) -> &'a [(LabelIndex, BlockIndex)],
+    {
+        // Keep the load factor below 3/4.
+        if 4 * self.len >= 3 * self.slots.len() {
+            self.grow();
+        }
+
+        let mask = self.slots.len() - 1;
+        let mut index = (hash as usize) & mask;
+        loop {
+            let (slot_hash, slot_block) = self.slots[index];
+            if slot_block == EMPTY {
+                self.slots[index] = (hash, block.value());
+                self.len += 1;
+                return (block, true);
+            }
+
+            if slot_hash == hash && lookup(BlockIndex::new(slot_block)) == signature {
+                return (BlockIndex::new(slot_block), false);
+            }
+
+            index = (index + 1) & mask;
+        }
+    }
+
+    /// Doubles the capacity of the table, reinserting the stored hashes.
+    fn grow(&mut self) {
+        let mut slots = vec![(0, EMPTY); 2 * self.slots.len()];
+        let mask = slots.len() - 1;
+
+        for &(hash, block) in self.slots.iter().filter(|(_, block)| *block != EMPTY) {
+            let mut index = (hash as usize) & mask;
+            while slots[index].1 != EMPTY {
+                index = (index + 1) & mask;
+            }
+
+            slots[index] = (hash, block);
+        }
+
+        self.slots = slots;
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use rand::Rng;
+
+    use merc_utilities::random_test;
+
+    use super::*;
+
+    #[test]
+    fn test_random_signature_table() {
+        random_test(100, |rng| {
+            let mut table = SignatureTable::with_capacity(4);
+            let mut signatures: Vec<Vec<(LabelIndex, BlockIndex)>> = Vec::new();
+
+            for _ in 0..256 {
+                let signature: Vec<(LabelIndex, BlockIndex)> = (0..rng.random_range(0..4))
+                    .map(|_| {
+                        (
+                            LabelIndex::new(rng.random_range(0..4)),
+                            BlockIndex::new(rng.random_range(0..4)),
+                        )
+                    })
+                    .collect();
+
+                let hash = table.hash(&signature);
+                let expected = signatures.iter().position(|other| *other == signature);
+
+                let (block, inserted) =
+                    table.find_or_insert(hash, &signature, BlockIndex::new(signatures.len()), |block| {
+                        &signatures[block.value()]
+                    });
+
+                match expected {
+                    Some(index) => {
+                        assert!(!inserted, "The signature was already in the table");
+                        assert_eq!(block.value(), index, "The existing block number should be returned");
+                    }
+                    None => {
+                        assert!(inserted, "The signature was not yet in the table");
+                        assert_eq!(block.value(), signatures.len(), "The new block number should be assigned");
+                        signatures.push(signature);
+                    }
+                }
+
+                assert_eq!(table.len(), signatures.len());
+            }
+        });
+    }
+}
@@ -11,12 +11,14 @@ use merc_lts::StateIndex;
 use rustc_hash::FxHashSet;
 
 use crate::BlockIndex;
+use crate::IndexedPartition;
 use crate::Partition;
-use crate::quotient_lts_naive;
+use crate::quotient_lts_streaming;
 
 use super::BlockPartition;
 use super::sort_topological;
 use super::tau_scc_decomposition;
+use super::tau_scc_decomposition_parallel;
 
 /// The builder used to construct the signature.
 pub type SignatureBuilder = Vec<(LabelIndex, BlockIndex)>;
@@ -300,7 +302,23 @@ pub fn weak_bisim_signature_sorted_taus(
 /// sorted signature see [branching_bisim_signature_sorted].
 pub fn preprocess_branching<L: LTS>(lts: L) -> LabelledTransitionSystem<L::Label> {
     let scc_partition = tau_scc_decomposition(&lts);
-    let tau_loop_free_lts = quotient_lts_naive(&lts, &scc_partition, true);
+    preprocess_branching_quotient(lts, &scc_partition)
+}
+
+/// Same as [preprocess_branching], but computes the tau SCC decomposition with
+/// the given number of worker threads.
+pub fn preprocess_branching_parallel<L: LTS + Sync>(lts: L, threads: usize) -> LabelledTransitionSystem<L::Label> {
+    let scc_partition = tau_scc_decomposition_parallel(&lts, threads);
+    preprocess_branching_quotient(lts, &scc_partition)
+}
+
+/// Quotients the LTS with the given tau SCC partition and sorts the states
+/// topologically with respect to the tau transitions.
+fn preprocess_branching_quotient<L: LTS>(
+    lts: L,
+    scc_partition: &IndexedPartition,
+) -> LabelledTransitionSystem<L::Label> {
+    let tau_loop_free_lts = quotient_lts_streaming(&lts, scc_partition, true);
     drop(lts);
 
     // Sort the states according to the topological order of the tau transitions.
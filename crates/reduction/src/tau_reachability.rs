@@ -0,0 +1,348 @@
+#![forbid(unsafe_code)]
+
+use log::debug;
+
+use merc_lts::LTS;
+use merc_lts::LabelIndex;
+use merc_lts::StateIndex;
+
+use crate::BlockIndex;
+use crate::Partition;
+use crate::SignatureBuilder;
+
+/// Answers tau-reachability queries against the current partition without
+/// materializing the tau-transitive closure.
+///
+/// For every state the oracle memoizes the set of blocks that contain a state
+/// reachable through hidden transitions, and on top of that the weak
+/// bisimulation signature. Both are recomputed lazily: an entry mentions the
+/// blocks it was computed from, so it remains valid as long as none of those
+/// blocks has been split since. The refinement loop reports splits through
+/// [TauReachabilityOracle::split_blocks], which only bumps the version of the
+/// affected blocks, so after a split only the states whose closure actually
+/// crosses a split block are recomputed.
+///
+/// The input LTS must contain no tau-cycles, see [crate::preprocess_branching].
+pub struct TauReachabilityOracle {
+    /// The blocks tau-reachable from every state, sorted and including the
+    /// block of the state itself.
+    tau_blocks: Vec<Vec<BlockIndex>>,
+    /// The version at which the tau-reachable blocks were computed, where zero
+    /// means never.
+    tau_version: Vec<usize>,
+
+    /// The weak bisimulation signature of every state.
+    signature: Vec<SignatureBuilder>,
+    /// The version at which the signature was computed, where zero means never.
+    signature_version: Vec<usize>,
+
+    /// The version at which every block was last split.
+    block_version: Vec<usize>,
+    /// The current version, bumped on every split.
+    version: usize,
+
+    /// The number of entries that were (re)computed, for diagnostics.
+    recomputations: usize,
+}
+
+impl TauReachabilityOracle {
+    /// Creates an oracle for the given number of states and the trivial
+    /// partition with a single block.
+    pub fn new(num_of_states: usize) -> TauReachabilityOracle {
+        TauReachabilityOracle {
+            tau_blocks: vec![Vec::new(); num_of_states],
+            tau_version: vec![0; num_of_states],
+            signature: vec![SignatureBuilder::default(); num_of_states],
+            signature_version: vec![0; num_of_states],
+            block_version: vec![1],
+            version: 1,
+            recomputations: 0,
+        }
+    }
+
+    /// Reports that the given blocks have been split and that the partition
+    /// now has the given number of blocks. Entries that mention a split block
+    /// or one of the new blocks become invalid.
+    pub fn split_blocks(&mut self, split: &[BlockIndex], num_of_blocks: usize) {
+        self.version += 1;
+
+        for &block_index in split {
+            self.block_version[block_index] = self.version;
+        }
+
+        debug_assert!(
+            num_of_blocks >= self.block_version.len(),
+            "The number of blocks can only grow"
+        );
+        self.block_version.resize(num_of_blocks, self.version);
+    }
+
+    /// Returns the blocks that contain a state reachable from the given state
+    /// through hidden transitions, including the block of the state itself.
+    pub fn tau_reachable_blocks(
+        &mut self,
+        state_index: StateIndex,
+        lts: &impl LTS,
+        partition: &impl Partition,
+    ) -> &[BlockIndex] {
+        self.ensure_tau_blocks(state_index, lts, partition);
+        &self.tau_blocks[state_index]
+    }
+
+    /// Returns the weak bisimulation signature of the given state, equal to
+    /// the result of [crate::weak_bisim_signature_sorted].
+    pub fn signature(
+        &mut self,
+        state_index: StateIndex,
+        lts: &impl LTS,
+        partition: &impl Partition,
+    ) -> &[(LabelIndex, BlockIndex)] {
+        self.ensure_signature(state_index, lts, partition);
+        &self.signature[state_index]
+    }
+
+    /// Logs the cache statistics of the oracle.
+    pub fn print_metrics(&self, num_of_states: usize, iterations: usize) {
+        debug!(
+            "Tau-reachability oracle: {} recomputations for {} states over {} iterations",
+            self.recomputations, num_of_states, iterations
+        );
+    }
+
+    /// Returns true iff the entry computed at the given version is still valid
+    /// for the blocks it mentions.
+    fn is_valid<'a>(&self, version: usize, mut blocks: impl Iterator<Item = &'a BlockIndex>) -> bool {
+        version != 0 && blocks.all(|&block_index| self.block_version[block_index] <= version)
+    }
+
+    /// Recomputes the tau-reachable blocks of every invalid state on which the
+    /// given state depends, in reverse depth first order.
+    fn ensure_tau_blocks(&mut self, state_index: StateIndex, lts: &impl LTS, partition: &impl Partition) {
+        if self.is_valid(self.tau_version[state_index], self.tau_blocks[state_index].iter()) {
+            return;
+        }
+
+        let mut stack = vec![(state_index, false)];
+        while let Some((state, expanded)) = stack.pop() {
+            if self.is_valid(self.tau_version[state], self.tau_blocks[state].iter()) {
+                continue;
+            }
+
+            if expanded {
+                // The hidden successors are valid, so combine their entries.
+                let mut blocks = std::mem::take(&mut self.tau_blocks[state]);
+                blocks.clear();
+                blocks.push(partition.block_number(state));
+
+                for transition in lts.outgoing_transitions(state) {
+                    if lts.is_hidden_label(transition.label) {
+                        blocks.extend_from_slice(&self.tau_blocks[transition.to]);
+                    }
+                }
+
+                blocks.sort_unstable();
+                blocks.dedup();
+
+                self.tau_blocks[state] = blocks;
+                self.tau_version[state] = self.version;
+                self.recomputations += 1;
+            } else {
+                stack.push((state, true));
+
+                for transition in lts.outgoing_transitions(state) {
+                    if lts.is_hidden_label(transition.label)
+                        && !self.is_valid(self.tau_version[transition.to], self.tau_blocks[transition.to].iter())
+                    {
+                        stack.push((transition.to, false));
+                    }
+                }
+            }
+        }
+    }
+
+    /// Recomputes the signature of every invalid state on which the given
+    /// state depends. A signature depends on the signatures of the hidden
+    /// successors and on the tau-reachable blocks of the visible successors.
+    fn ensure_signature(&mut self, state_index: StateIndex, lts: &impl LTS, partition: &impl Partition) {
+        if self.is_valid(
+            self.signature_version[state_index],
+            self.signature[state_index].iter().map(|(_, block)| block),
+        ) {
+            return;
+        }
+
+        let mut stack = vec![(state_index, false)];
+        while let Some((state, expanded)) = stack.pop() {
+            if self.is_valid(
+                self.signature_version[state],
+                self.signature[state].iter().map(|(_, block)| block),
+            ) {
+                continue;
+            }
+
+            if expanded {
+                let mut builder = std::mem::take(&mut self.signature[state]);
+                builder.clear();
+
+                // The tau pairs are exactly the tau-reachable blocks.
+                self.ensure_tau_blocks(state, lts, partition);
+                builder.extend(self.tau_blocks[state].iter().map(|&block| (LabelIndex::new(0), block)));
+
+                for transition in lts.outgoing_transitions(state) {
+                    if lts.is_hidden_label(transition.label) {
+                        // Inert tau transition, take over the signature of the successor.
+                        builder.extend_from_slice(&self.signature[transition.to]);
+                    } else {
+                        // A visible action followed by any number of tau steps.
+                        self.ensure_tau_blocks(transition.to, lts, partition);
+                        builder.extend(
+                            self.tau_blocks[transition.to]
+                                .iter()
+                                .map(|&block| (transition.label, block)),
+                        );
+                    }
+                }
+
+                builder.sort_unstable();
+                builder.dedup();
+
+                self.signature[state] = builder;
+                self.signature_version[state] = self.version;
+                self.recomputations += 1;
+            } else {
+                stack.push((state, true));
+
+                for transition in lts.outgoing_transitions(state) {
+                    if lts.is_hidden_label(transition.label)
+                        && !self.is_valid(
+                            self.signature_version[transition.to],
+                            self.signature[transition.to].iter().map(|(_, block)| block),
+                        )
+                    {
+                        stack.push((transition.to, false));
+                    }
+                }
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use merc_lts::random_lts;
+    use merc_utilities::random_test;
+    use rand::Rng;
+    use test_log::test;
+
+    use crate::IndexedPartition;
+    use crate::preprocess_branching;
+    use crate::tau_scc_decomposition;
+
+    use super::*;
+
+    /// Computes the tau-reachable blocks of the given state directly.
+    fn naive_tau_reachable_blocks(
+        lts: &impl LTS,
+        partition: &impl Partition,
+        state_index: StateIndex,
+    ) -> Vec<BlockIndex> {
+        let mut visited = vec![state_index];
+        let mut stack = vec![state_index];
+
+        while let Some(state) = stack.pop() {
+            for transition in lts.outgoing_transitions(state) {
+                if lts.is_hidden_label(transition.label) && !visited.contains(&transition.to) {
+                    visited.push(transition.to);
+                    stack.push(transition.to);
+                }
+            }
+        }
+
+        let mut blocks: Vec<BlockIndex> = visited.iter().map(|&state| partition.block_number(state)).collect();
+        blocks.sort_unstable();
+        blocks.dedup();
+        blocks
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_random_tau_reachability_oracle() {
+        random_test(100, |rng| {
+            let lts = preprocess_branching(random_lts(rng, 10, 3, 3));
+
+            // Start from the tau SCC partition, which is trivial after
+            // preprocessing but has multiple blocks.
+            let mut partition = tau_scc_decomposition(&lts);
+            let mut oracle = TauReachabilityOracle::new(lts.num_of_states());
+            oracle.split_blocks(&[BlockIndex::new(0)], partition.num_of_blocks());
+
+            for state_index in lts.iter_states() {
+                assert_eq!(
+                    oracle.tau_reachable_blocks(state_index, &lts, &partition),
+                    naive_tau_reachable_blocks(&lts, &partition, state_index),
+                    "The oracle should agree with the direct computation"
+                );
+            }
+
+            // Split a random block and check that the invalidation is correct.
+            let split_block = BlockIndex::new(rng.random_range(0..partition.num_of_blocks()));
+            let new_block = BlockIndex::new(partition.num_of_blocks());
+
+            let mut split = false;
+            for state_index in lts.iter_states() {
+                if partition.block_number(state_index) == split_block && rng.random_bool(0.5) {
+                    partition.set_block(state_index, new_block);
+                    split = true;
+                }
+            }
+
+            if split {
+                oracle.split_blocks(&[split_block], partition.num_of_blocks());
+            }
+
+            for state_index in lts.iter_states() {
+                assert_eq!(
+                    oracle.tau_reachable_blocks(state_index, &lts, &partition),
+                    naive_tau_reachable_blocks(&lts, &partition, state_index),
+                    "The oracle should agree with the direct computation after the split"
+                );
+            }
+        });
+    }
+
+    #[test]
+    fn test_tau_reachability_oracle_validity() {
+        // A chain 0 -tau-> 1 -tau-> 2 in separate blocks.
+        let transitions = [(0, 0, 1), (1, 0, 2)]
+            .map(|(from, label, to)| (StateIndex::new(from), LabelIndex::new(label), StateIndex::new(to)));
+
+        let lts = merc_lts::LabelledTransitionSystem::new(
+            StateIndex::new(0),
+            None,
+            || transitions.iter().cloned(),
+            vec!["tau".to_string()],
+        );
+
+        let mut partition = IndexedPartition::new(3);
+        partition.set_block(StateIndex::new(1), BlockIndex::new(1));
+        partition.set_block(StateIndex::new(2), BlockIndex::new(2));
+
+        let mut oracle = TauReachabilityOracle::new(3);
+        oracle.split_blocks(&[BlockIndex::new(0)], 3);
+
+        assert_eq!(
+            oracle.tau_reachable_blocks(StateIndex::new(0), &lts, &partition),
+            [BlockIndex::new(0), BlockIndex::new(1), BlockIndex::new(2)]
+        );
+
+        // Splitting an unrelated new block keeps the entries valid.
+        let recomputations = oracle.recomputations;
+        oracle.split_blocks(&[], 4);
+
+        oracle.tau_reachable_blocks(StateIndex::new(0), &lts, &partition);
+        assert_eq!(
+            oracle.recomputations, recomputations,
+            "The entries mention no split block and should remain valid"
+        );
+    }
+}
@@ -10,7 +10,7 @@ use bitvec::vec::BitVec;
 use log::info;
 use log::trace;
 use merc_io::TimeProgress;
-use merc_lts::IncomingTransitions;
+use merc_lts::TransitionTable;
 use merc_lts::LTS;
 use merc_lts::LabelIndex;
 use merc_lts::LabelledTransitionSystem;
@@ -38,7 +38,7 @@ pub fn weak_bisimulation<L: LTS>(
     let mut act_mark = bitvec![u64, Lsb0; 0; tau_loop_free_lts.num_of_states()];
     let mut tau_mark = bitvec![u64, Lsb0; 0; tau_loop_free_lts.num_of_states()];
 
-    let incoming = IncomingTransitions::new(&tau_loop_free_lts);
+    let incoming = TransitionTable::new(&tau_loop_free_lts);
 
     let progress = TimeProgress::new(
         |num_of_blocks: usize| {
@@ -102,7 +102,7 @@ fn compute_weak_act(
     tau_mark: &mut BitArray,
     lts: &impl LTS,
     blocks: &SimpleBlockPartition,
-    incoming: &IncomingTransitions,
+    incoming: &TransitionTable,
     block: BlockIndex,
     label: LabelIndex,
 ) {
@@ -6,7 +6,11 @@ use criterion::Criterion;
 use criterion::criterion_group;
 use criterion::criterion_main;
 
+use merc_data::to_untyped_data_expression;
 use merc_rec_tests::load_rec_from_strings;
+use merc_sabre::CompiledRewriter;
+use merc_sabre::InnermostRewriter;
+use merc_sabre::RewriteEngine;
 use merc_sabre::SetAutomaton;
 
 pub fn criterion_benchmark_set_automaton(c: &mut Criterion) {
@@ -29,5 +33,39 @@ pub fn criterion_benchmark_set_automaton(c: &mut Criterion) {
     }
 }
 
-criterion_group!(benches, criterion_benchmark_set_automaton,);
+pub fn criterion_benchmark_rewriter(c: &mut Criterion) {
+    let (name, rec_files) = (
+        "fibonacci05",
+        [
+            include_str!("../../../../examples/REC/rec/fibonacci05.rec"),
+            include_str!("../../../../examples/REC/rec/fibonacci.rec"),
+        ],
+    );
+    let (syntax_spec, syntax_terms) = load_rec_from_strings(&rec_files).unwrap();
+    let spec = syntax_spec.to_rewrite_spec();
+    let terms: Vec<_> = syntax_terms
+        .iter()
+        .map(|t| to_untyped_data_expression(t.clone(), None))
+        .collect();
+
+    let mut innermost = InnermostRewriter::new(&spec);
+    c.bench_function(&format!("innermost rewrite {}", name), |bencher| {
+        bencher.iter(|| {
+            for term in &terms {
+                let _ = black_box(innermost.rewrite(term));
+            }
+        });
+    });
+
+    let mut compiled = CompiledRewriter::new(&spec);
+    c.bench_function(&format!("compiled rewrite {}", name), |bencher| {
+        bencher.iter(|| {
+            for term in &terms {
+                let _ = black_box(compiled.rewrite(term));
+            }
+        });
+    });
+}
+
+criterion_group!(benches, criterion_benchmark_set_automaton, criterion_benchmark_rewriter,);
 criterion_main!(benches);
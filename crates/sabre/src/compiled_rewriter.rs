@@ -0,0 +1,398 @@
+#![forbid(unsafe_code)]
+
+use ahash::HashMap;
+use log::info;
+use smallvec::SmallVec;
+
+use merc_aterm::storage::THREAD_TERM_POOL;
+use merc_aterm::storage::ThreadTermPool;
+use merc_data::DataApplication;
+use merc_data::DataExpression;
+use merc_data::DataExpressionRef;
+
+use crate::AnnouncementInnermost;
+use crate::RewriteEngine;
+use crate::RewriteSpecification;
+use crate::RewritingStatistics;
+use crate::matching::nonlinear::check_equivalence_classes;
+use crate::set_automaton::MatchAnnouncement;
+use crate::set_automaton::SetAutomaton;
+use crate::utilities::Config;
+use crate::utilities::DataPosition;
+use crate::utilities::DataPositionIndexed;
+use crate::utilities::InnermostStack;
+use crate::utilities::TermStackBuilder;
+use merc_utilities::debug_trace;
+
+/// Sentinel for an operation id without a compact symbol index.
+const NO_SYMBOL: u32 = u32::MAX;
+
+/// Sentinel for a (state, symbol) pair without a transition.
+const NO_TRANSITION: u32 = u32::MAX;
+
+/// An innermost rewrite engine that compiles the APMA into a [MatchProgram]
+/// ahead of time.
+///
+/// Where [crate::InnermostRewriter] interprets the automaton by looking up
+/// every transition in a hash map keyed on (state, operation id), this engine
+/// flattens the automaton into dense tables so that every step of the matching
+/// loop is a computed array index. This removes the hashing and probing from
+/// the hot loop of every rewrite step; the rewriting itself reuses the
+/// innermost stack machinery.
+pub struct CompiledRewriter {
+    program: MatchProgram,
+    stack: InnermostStack,
+    builder: TermStackBuilder,
+}
+
+impl RewriteEngine for CompiledRewriter {
+    fn rewrite(&mut self, t: &DataExpression) -> DataExpression {
+        let mut stats = RewritingStatistics::default();
+
+        debug_trace!("input: {}", t);
+
+        let result = THREAD_TERM_POOL.with_borrow(|tp| {
+            CompiledRewriter::rewrite_aux(tp, &mut self.stack, &mut self.builder, &mut stats, &self.program, t)
+        });
+
+        info!(
+            "{} rewrites, {} single steps and {} symbol comparisons",
+            stats.recursions, stats.rewrite_steps, stats.symbol_comparisons
+        );
+        result
+    }
+}
+
+impl CompiledRewriter {
+    /// Creates a new CompiledRewriter from the given rewrite specification.
+    pub fn new(spec: &RewriteSpecification) -> CompiledRewriter {
+        let apma = SetAutomaton::new(spec, AnnouncementInnermost::new, true);
+
+        CompiledRewriter {
+            program: MatchProgram::compile(apma),
+            stack: InnermostStack::default(),
+            builder: TermStackBuilder::new(),
+        }
+    }
+
+    /// Function to rewrite a term 't'. Uses the same stack based evaluation as
+    /// [crate::InnermostRewriter::rewrite_aux], but matches against the
+    /// compiled program instead of the automaton.
+    fn rewrite_aux(
+        tp: &ThreadTermPool,
+        stack: &mut InnermostStack,
+        builder: &mut TermStackBuilder,
+        stats: &mut RewritingStatistics,
+        program: &MatchProgram,
+        input_term: &DataExpression,
+    ) -> DataExpression {
+        stats.recursions += 1;
+        {
+            let mut write_terms = stack.terms.write();
+            let mut write_configs = stack.configs.write();
+
+            // Push the result term to the stack.
+            let top_of_stack = write_terms.len();
+            write_configs.push(Config::Return());
+            write_terms.push(None);
+            InnermostStack::add_rewrite(&mut write_configs, &mut write_terms, input_term.copy(), top_of_stack);
+        }
+
+        loop {
+            debug_trace!("{}", stack);
+
+            let mut write_configs = stack.configs.write();
+            if let Some(config) = write_configs.pop() {
+                match config {
+                    Config::Rewrite(result) => {
+                        let mut write_terms = stack.terms.write();
+                        let term = write_terms.pop().unwrap().unwrap();
+
+                        let symbol = term.data_function_symbol();
+                        let arguments = term.data_arguments();
+
+                        // For all the argument we reserve space on the stack.
+                        let top_of_stack = write_terms.len();
+                        for _ in 0..arguments.len() {
+                            write_terms.push(Default::default());
+                        }
+
+                        let symbol = write_configs.protect(&symbol);
+                        InnermostStack::add_result(&mut write_configs, symbol.into(), arguments.len(), result);
+                        for (offset, arg) in arguments.into_iter().enumerate() {
+                            InnermostStack::add_rewrite(
+                                &mut write_configs,
+                                &mut write_terms,
+                                arg,
+                                top_of_stack + offset,
+                            );
+                        }
+                        drop(write_configs);
+                    }
+                    Config::Construct(symbol, arity, index) => {
+                        // Take the last arity arguments.
+                        let mut write_terms = stack.terms.write();
+                        let length = write_terms.len();
+
+                        let arguments = &write_terms[length - arity..];
+
+                        let term: DataExpression = if arguments.is_empty() {
+                            symbol.protect().into()
+                        } else {
+                            DataApplication::with_iter(&symbol, arguments.len(), arguments.iter().flatten()).into()
+                        };
+
+                        // Remove the arguments from the stack.
+                        write_terms.drain(length - arity..);
+                        drop(write_terms);
+                        drop(write_configs);
+
+                        match CompiledRewriter::find_match(tp, stack, builder, stats, program, &term.copy()) {
+                            Some((_announcement, annotation)) => {
+                                debug_trace!(
+                                    "rewrite {} => {} using rule {}",
+                                    term,
+                                    annotation.rhs_stack.evaluate(&term),
+                                    _announcement.rule
+                                );
+
+                                // Reacquire the write access and add the matching RHSStack.
+                                let mut write_terms = stack.terms.write();
+                                let mut write_configs = stack.configs.write();
+                                InnermostStack::integrate(
+                                    &mut write_configs,
+                                    &mut write_terms,
+                                    &annotation.rhs_stack,
+                                    &term.copy(),
+                                    index,
+                                );
+                                stats.rewrite_steps += 1;
+                            }
+                            None => {
+                                // Add the term on the stack.
+                                let mut write_terms = stack.terms.write();
+                                write_terms[index] = Some(write_terms.protect(&term).into());
+                            }
+                        }
+                    }
+                    Config::Term(_, _) => {
+                        unreachable!("This case should not happen");
+                    }
+                    Config::Return() => {
+                        let mut write_terms = stack.terms.write();
+
+                        return write_terms
+                            .pop()
+                            .expect("The result should be the last element on the stack")
+                            .expect("The result should be Some")
+                            .protect();
+                    }
+                }
+            }
+        }
+    }
+
+    /// Use the match program to find a match for the given term.
+    fn find_match<'a>(
+        tp: &ThreadTermPool,
+        stack: &mut InnermostStack,
+        builder: &mut TermStackBuilder,
+        stats: &mut RewritingStatistics,
+        program: &'a MatchProgram,
+        t: &DataExpressionRef<'_>,
+    ) -> Option<(&'a MatchAnnouncement, &'a AnnouncementInnermost)> {
+        // Start at the initial state
+        let mut state_index = 0;
+        loop {
+            // Get the symbol at the position of the state label.
+            stats.symbol_comparisons += 1;
+            let pos = t.get_data_position(&program.labels[state_index]);
+            let symbol = pos.data_function_symbol();
+
+            // Dispatch on the compact symbol index; symbols that do not occur
+            // in the specification have no index and thus no match.
+            let symbol_index = match program.symbol_index.get(symbol.operation_id()) {
+                Some(index) => index,
+                None => return None,
+            };
+
+            let entry = program.dispatch[state_index * program.num_of_symbols + symbol_index];
+            if entry == NO_TRANSITION {
+                return None;
+            }
+
+            let transition = &program.transitions[entry as usize];
+            for (announcement, annotation) in &transition.announcements {
+                if check_equivalence_classes(t, &annotation.equivalence_classes)
+                    && CompiledRewriter::check_conditions(tp, stack, builder, stats, program, annotation, t)
+                {
+                    // We found a matching pattern
+                    return Some((announcement, annotation));
+                }
+            }
+
+            // If there is no pattern match we check if the transition has a destination state
+            match transition.destination {
+                Some(destination) => state_index = destination,
+                None => return None,
+            }
+        }
+    }
+
+    /// Checks whether the condition holds for given match announcement.
+    fn check_conditions(
+        tp: &ThreadTermPool,
+        stack: &mut InnermostStack,
+        builder: &mut TermStackBuilder,
+        stats: &mut RewritingStatistics,
+        program: &MatchProgram,
+        announcement: &AnnouncementInnermost,
+        t: &DataExpressionRef<'_>,
+    ) -> bool {
+        for c in &announcement.conditions {
+            let rhs: DataExpression = c.rhs_term_stack.evaluate_with(t, builder);
+            let lhs: DataExpression = c.lhs_term_stack.evaluate_with(t, builder);
+
+            let rhs_normal = CompiledRewriter::rewrite_aux(tp, stack, builder, stats, program, &rhs);
+            let lhs_normal = CompiledRewriter::rewrite_aux(tp, stack, builder, stats, program, &lhs);
+
+            if lhs_normal != rhs_normal && c.equality || lhs_normal == rhs_normal && !c.equality {
+                return false;
+            }
+        }
+
+        true
+    }
+}
+
+/// The compiled form of an APMA [SetAutomaton].
+///
+/// The hash map of transitions keyed on (state, operation id) is flattened
+/// into a dense dispatch table. Operation ids are first mapped onto a compact
+/// symbol index, such that the dispatch table has num_of_states times
+/// num_of_symbols entries pointing into the transition list.
+struct MatchProgram {
+    /// The position label of every state.
+    labels: Vec<DataPosition>,
+
+    /// Maps an operation id onto a compact symbol index.
+    symbol_index: SymbolIndexTable,
+
+    /// The number of symbols occurring in the specification.
+    num_of_symbols: usize,
+
+    /// Maps state * num_of_symbols + symbol onto a transition, or [NO_TRANSITION].
+    dispatch: Vec<u32>,
+
+    /// The compiled transitions.
+    transitions: Vec<CompiledTransition>,
+}
+
+/// A transition of the [MatchProgram], with only the information used while
+/// matching.
+struct CompiledTransition {
+    announcements: SmallVec<[(MatchAnnouncement, AnnouncementInnermost); 1]>,
+    destination: Option<usize>,
+}
+
+impl MatchProgram {
+    /// Compiles the given automaton into the flat program representation.
+    fn compile(automaton: SetAutomaton<AnnouncementInnermost>) -> MatchProgram {
+        let (states, transitions) = automaton.into_parts();
+        let labels: Vec<DataPosition> = states.iter().map(|state| state.label().clone()).collect();
+
+        // Assign a compact index to every symbol occurring on a transition.
+        let mut index_of: HashMap<usize, usize> = HashMap::default();
+        for (_, operation_id) in transitions.keys() {
+            let num_of_symbols = index_of.len();
+            index_of.entry(*operation_id).or_insert(num_of_symbols);
+        }
+
+        let mut symbol_index = SymbolIndexTable::with_capacity(index_of.len());
+        for (operation_id, index) in &index_of {
+            symbol_index.insert(*operation_id, *index as u32);
+        }
+
+        // Flatten the transitions into the dispatch table.
+        let num_of_symbols = index_of.len();
+        let mut dispatch = vec![NO_TRANSITION; labels.len() * num_of_symbols];
+        let mut compiled = Vec::with_capacity(transitions.len());
+
+        for ((state, operation_id), transition) in transitions {
+            dispatch[state * num_of_symbols + index_of[&operation_id]] = compiled.len() as u32;
+            compiled.push(CompiledTransition {
+                announcements: transition.announcements,
+                destination: transition.destinations.first().map(|(_, destination)| *destination),
+            });
+        }
+
+        MatchProgram {
+            labels,
+            symbol_index,
+            num_of_symbols,
+            dispatch,
+            transitions: compiled,
+        }
+    }
+}
+
+/// An open addressed table mapping operation ids onto compact symbol indices.
+///
+/// Operation ids are term pool indices, so they are unique numbers that are
+/// too sparse for a direct lookup table. The table uses Fibonacci hashing with
+/// linear probing at a low load factor, so a lookup is a multiply, a shift and
+/// usually a single probe instead of hashing a (state, operation id) pair.
+struct SymbolIndexTable {
+    entries: Vec<(usize, u32)>,
+    shift: u32,
+}
+
+impl SymbolIndexTable {
+    /// Creates a table for the given number of symbols.
+    fn with_capacity(num_of_symbols: usize) -> SymbolIndexTable {
+        let capacity = (4 * num_of_symbols).next_power_of_two().max(8);
+
+        SymbolIndexTable {
+            entries: vec![(0, NO_SYMBOL); capacity],
+            shift: usize::BITS - capacity.trailing_zeros(),
+        }
+    }
+
+    /// Returns the first table index to probe for the given operation id.
+    fn hash(&self, operation_id: usize) -> usize {
+        operation_id.wrapping_mul(0x9E37_79B9_7F4A_7C15) >> self.shift
+    }
+
+    /// Inserts the symbol index for the given operation id.
+    fn insert(&mut self, operation_id: usize, index: u32) {
+        debug_assert!(index != NO_SYMBOL, "The sentinel cannot be used as a symbol index");
+
+        let mask = self.entries.len() - 1;
+        let mut entry = self.hash(operation_id);
+        while self.entries[entry].1 != NO_SYMBOL {
+            debug_assert!(self.entries[entry].0 != operation_id, "Operation ids must be unique");
+            entry = (entry + 1) & mask;
+        }
+
+        self.entries[entry] = (operation_id, index);
+    }
+
+    /// Returns the symbol index for the given operation id, or None when the
+    /// operation id does not occur in the table.
+    fn get(&self, operation_id: usize) -> Option<usize> {
+        let mask = self.entries.len() - 1;
+        let mut entry = self.hash(operation_id);
+        loop {
+            let (stored, index) = self.entries[entry];
+            if index == NO_SYMBOL {
+                return None;
+            }
+
+            if stored == operation_id {
+                return Some(index as usize);
+            }
+
+            entry = (entry + 1) & mask;
+        }
+    }
+}
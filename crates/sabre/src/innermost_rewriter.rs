@@ -40,6 +40,7 @@ impl RewriteEngine for InnermostRewriter {
             "{} rewrites, {} single steps and {} symbol comparisons",
             stats.recursions, stats.rewrite_steps, stats.symbol_comparisons
         );
+        stats.record_metrics();
         result
     }
 }
@@ -1,5 +1,6 @@
 #![doc = include_str!("../README.md")]
 
+mod compiled_rewriter;
 mod innermost_rewriter;
 mod matching;
 mod naive_rewriter;
@@ -10,6 +11,7 @@ mod set_automaton;
 pub mod test_utility;
 pub mod utilities;
 
+pub use compiled_rewriter::*;
 pub use innermost_rewriter::*;
 pub use naive_rewriter::*;
 pub use rewrite_specification::*;
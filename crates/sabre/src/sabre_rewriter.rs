@@ -6,6 +6,7 @@ use merc_aterm::storage::THREAD_TERM_POOL;
 use merc_aterm::storage::ThreadTermPool;
 use merc_data::DataExpression;
 use merc_data::DataExpressionRef;
+use merc_utilities::count;
 use merc_utilities::debug_trace;
 
 use crate::RewriteSpecification;
@@ -34,6 +35,16 @@ pub struct RewritingStatistics {
     pub recursions: usize,
 }
 
+impl RewritingStatistics {
+    /// Adds the statistics of a single rewrite to the performance metrics.
+    pub fn record_metrics(&self) {
+        count("sabre.rewrites", 1);
+        count("sabre.rewrite_steps", self.rewrite_steps as u64);
+        count("sabre.symbol_comparisons", self.symbol_comparisons as u64);
+        count("sabre.recursions", self.recursions as u64);
+    }
+}
+
 /// The Set Automaton based Rewrite Engine implementation.
 pub struct SabreRewriter {
     automaton: SetAutomaton<AnnouncementSabre>,
@@ -63,6 +74,7 @@ impl SabreRewriter {
             "{} rewrites, {} single steps and {} symbol comparisons",
             stats.recursions, stats.rewrite_steps, stats.symbol_comparisons
         );
+        stats.record_metrics();
 
         result
     }
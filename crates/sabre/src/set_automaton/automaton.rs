@@ -268,6 +268,11 @@ impl<M> SetAutomaton<M> {
         &self.transitions
     }
 
+    /// Decomposes the automaton into its states and transitions.
+    pub fn into_parts(self) -> (Vec<State>, HashMap<(usize, usize), Transition<M>>) {
+        (self.states, self.transitions)
+    }
+
     /// Provides a formatter for the .dot file format
     pub fn to_dot_graph(&self, show_backtransitions: bool, show_final: bool) -> DotFormatter<'_, M> {
         DotFormatter {
@@ -0,0 +1,94 @@
+use std::hint::black_box;
+use std::time::Instant;
+
+use criterion::Criterion;
+use criterion::criterion_group;
+use criterion::criterion_main;
+
+use merc_ldd::Storage;
+use merc_symbolic::ReachabilityStrategy;
+use merc_symbolic::read_sylvan;
+use merc_symbolic::reachability_with_strategy;
+
+/// The checked-in corpus of Sylvan-format models; the smallest instance of
+/// every family such that a full benchmark run remains feasible on the CI
+/// runners.
+const CORPUS: &[(&str, &[u8])] = &[
+    ("anderson.4", include_bytes!("../../../../examples/ldd/anderson.4.ldd")),
+    ("bakery.4", include_bytes!("../../../../examples/ldd/bakery.4.ldd")),
+    ("blocks.4", include_bytes!("../../../../examples/ldd/blocks.4.ldd")),
+    ("lifts.6", include_bytes!("../../../../examples/ldd/lifts.6.ldd")),
+    (
+        "schedule_world.2",
+        include_bytes!("../../../../examples/ldd/schedule_world.2.ldd"),
+    ),
+];
+
+const STRATEGIES: &[(&str, ReachabilityStrategy)] = &[
+    ("bfs", ReachabilityStrategy::Bfs),
+    ("chaining", ReachabilityStrategy::Chaining),
+    ("saturation", ReachabilityStrategy::Saturation),
+];
+
+/// Runs every model and strategy once on a fresh storage and prints a JSON
+/// line per run with the number of states, the peak node count, the number of
+/// garbage collections, the cache hit rate and the wall time. These lines can
+/// be collected by the benchmark workflow to track regressions beyond wall
+/// time alone.
+fn report_metrics() {
+    for (model, bytes) in CORPUS {
+        for (name, strategy) in STRATEGIES {
+            let mut storage = Storage::new();
+            let lts = read_sylvan(&mut storage, &mut &bytes[..]).expect("The corpus models should load correctly");
+
+            let start = Instant::now();
+            let states =
+                reachability_with_strategy(&mut storage, &lts, *strategy).expect("Reachability should not fail");
+            let time = start.elapsed();
+
+            let (hits, misses, evictions) = storage.operation_cache().metrics();
+            println!(
+                "{}",
+                serde_json::json!({
+                    "model": model,
+                    "strategy": name,
+                    "states": states,
+                    "peak_nodes": storage.peak_num_of_nodes(),
+                    "garbage_collections": storage.num_of_garbage_collections(),
+                    "cache_hits": hits,
+                    "cache_misses": misses,
+                    "cache_evictions": evictions,
+                    "wall_time_seconds": time.as_secs_f64(),
+                })
+            );
+        }
+    }
+}
+
+pub fn criterion_benchmark(c: &mut Criterion) {
+    report_metrics();
+
+    for (model, bytes) in CORPUS {
+        for (name, strategy) in STRATEGIES {
+            c.bench_function(&format!("reachability {model} {name}"), |bencher| {
+                let mut storage = Storage::new();
+                let lts =
+                    read_sylvan(&mut storage, &mut &bytes[..]).expect("The corpus models should load correctly");
+
+                bencher.iter(|| {
+                    black_box(
+                        reachability_with_strategy(&mut storage, &lts, *strategy)
+                            .expect("Reachability should not fail"),
+                    );
+                })
+            });
+        }
+    }
+}
+
+criterion_group! {
+    name = benches;
+    config = Criterion::default().sample_size(10);
+    targets = criterion_benchmark
+}
+criterion_main!(benches);
@@ -0,0 +1,392 @@
+use std::hash::RandomState;
+
+use log::info;
+use oxidd::BooleanFunction;
+use oxidd::BooleanFunctionQuant;
+use oxidd::BooleanOperator;
+use oxidd::FunctionSubst;
+use oxidd::ManagerRef;
+use oxidd::Subst;
+use oxidd::bdd::BDDFunction;
+use oxidd::bdd::BDDManagerRef;
+use oxidd::util::SatCountCache;
+
+use merc_io::TimeProgress;
+use merc_ldd::DataRef;
+use merc_ldd::LddRef;
+use merc_ldd::Storage;
+use merc_ldd::Value;
+use merc_ldd::height;
+use merc_utilities::MercError;
+
+use crate::SymbolicLTS;
+use crate::TransitionGroup;
+use crate::create_variables;
+
+/// The bit-blasted variable layout shared by the state sets and the transition
+/// relations.
+///
+/// # Details
+///
+/// Every level of the state vector is encoded with enough bits for its highest
+/// value. The current and next-state copy of every bit are interleaved, i.e.,
+/// bit `k` of the state vector is the variable `2k` and its next-state copy is
+/// the variable `2k + 1`. The interleaving keeps the identity relation of an
+/// unchanged level linear in the number of bits.
+struct BddEncoding {
+    /// The number of bits for every level of the state vector.
+    bits: Vec<u32>,
+
+    /// The variable offset of the current-state bits for every level.
+    offsets: Vec<u32>,
+
+    /// The total number of current-state bits.
+    state_bits: u32,
+
+    /// All `2 * state_bits` variables of the manager, interleaved.
+    variables: Vec<BDDFunction>,
+}
+
+impl BddEncoding {
+    /// Creates the encoding for the given number of bits per level, adding the
+    /// variables to the manager.
+    fn new(manager_ref: &BDDManagerRef, bits: Vec<u32>) -> Result<Self, MercError> {
+        let mut offsets = Vec::with_capacity(bits.len());
+        let mut state_bits = 0;
+        for &b in &bits {
+            offsets.push(state_bits);
+            state_bits += b;
+        }
+
+        let variables = create_variables(manager_ref, 2 * state_bits)?;
+
+        Ok(Self {
+            bits,
+            offsets,
+            state_bits,
+            variables,
+        })
+    }
+
+    /// Returns the current-state variable for the given bit index.
+    fn current(&self, bit: u32) -> &BDDFunction {
+        &self.variables[2 * bit as usize]
+    }
+
+    /// Returns the next-state variable for the given bit index.
+    fn next(&self, bit: u32) -> &BDDFunction {
+        &self.variables[2 * bit as usize + 1]
+    }
+
+    /// Constrains the bits of the given level, starting at `base`, to encode
+    /// the given value. `next` selects the next-state instead of the
+    /// current-state variables.
+    fn encode_value(&self, mut bdd: BDDFunction, level: usize, value: Value, next: bool) -> Result<BDDFunction, MercError> {
+        let base = self.offsets[level];
+        let bits = self.bits[level];
+
+        for i in 0..bits {
+            // Encode with the high bit first, matching [ldd_to_bdd].
+            let bit = base + (bits - i - 1);
+            let variable = if next { self.next(bit) } else { self.current(bit) };
+
+            if value & (1 << i) != 0 {
+                bdd = bdd.and(variable)?;
+            } else {
+                bdd = bdd.and(&variable.not()?)?;
+            }
+        }
+
+        Ok(bdd)
+    }
+
+    /// Returns the BDD expressing that the given level is unchanged, i.e., the
+    /// biimplication of the current and next-state bits.
+    fn identity_level(&self, manager_ref: &BDDManagerRef, level: usize) -> Result<BDDFunction, MercError> {
+        let mut bdd = manager_ref.with_manager_shared(|manager| BDDFunction::t(manager));
+
+        let base = self.offsets[level];
+        for bit in base..base + self.bits[level] {
+            bdd = bdd.and(&self.current(bit).equiv(self.next(bit))?)?;
+        }
+
+        Ok(bdd)
+    }
+}
+
+/// A transition group converted into a total bit-blasted transition relation.
+struct BddTransitionGroup {
+    relation: BDDFunction,
+}
+
+/// Performs reachability analysis on the bit-blasted BDD representation of the
+/// given symbolic LTS. Returns the number of reachable states.
+///
+/// # Details
+///
+/// The LDD state sets and sparse transition relations are converted into BDDs
+/// over the layout described in [BddEncoding], where the relations are made
+/// total by adding identities for the untouched levels. Every exploration step
+/// is then a native relational product: a combined and-exists over the
+/// current-state variables followed by renaming the next-state variables back.
+/// For models with large value domains this representation can be considerably
+/// smaller than the LDD one.
+pub fn reachability_bdd(
+    storage: &mut Storage,
+    manager_ref: &BDDManagerRef,
+    lts: &impl SymbolicLTS,
+) -> Result<usize, MercError> {
+    // Determine the number of bits per level from the initial state and the
+    // values that occur in the transition relations.
+    let mut highest = compute_highest(storage, lts.initial_state());
+    for group in lts.transition_groups() {
+        compute_highest_rel(storage, &mut highest, group.relation(), group.meta(), 0);
+    }
+
+    let bits: Vec<u32> = highest.iter().map(|&h| u32::BITS - h.leading_zeros()).collect();
+    let encoding = BddEncoding::new(manager_ref, bits)?;
+
+    let initial = ldd_set_to_bdd(storage, manager_ref, &encoding, lts.initial_state(), 0)?;
+
+    // The identity suffixes express that all levels from a given level onwards
+    // are unchanged; they close off the converted relations.
+    let num_of_levels = encoding.bits.len();
+    let mut identity_suffix = vec![manager_ref.with_manager_shared(|manager| BDDFunction::t(manager))];
+    for level in (0..num_of_levels).rev() {
+        let identity = encoding.identity_level(manager_ref, level)?;
+        let suffix = identity.and(identity_suffix.last().expect("The suffix list is never empty"))?;
+        identity_suffix.push(suffix);
+    }
+    identity_suffix.reverse();
+
+    let groups = lts
+        .transition_groups()
+        .iter()
+        .map(|group| {
+            Ok(BddTransitionGroup {
+                relation: ldd_rel_to_bdd(
+                    storage,
+                    manager_ref,
+                    &encoding,
+                    &identity_suffix,
+                    group.relation(),
+                    group.meta(),
+                    0,
+                )?,
+            })
+        })
+        .collect::<Result<Vec<_>, MercError>>()?;
+
+    // The cube of current-state variables to quantify, and the substitution
+    // renaming the next-state variables back to the current-state variables.
+    let mut current_cube = manager_ref.with_manager_shared(|manager| BDDFunction::t(manager));
+    for bit in 0..encoding.state_bits {
+        current_cube = current_cube.and(encoding.current(bit))?;
+    }
+
+    let rename = Subst::new(
+        (0..encoding.state_bits).map(|bit| 2 * bit + 1).collect::<Vec<_>>(),
+        (0..encoding.state_bits)
+            .map(|bit| encoding.current(bit).clone())
+            .collect::<Vec<_>>(),
+    );
+
+    // The usual breadth-first exploration, but with BDD operations.
+    let mut todo = initial.clone();
+    let mut states = initial;
+    let mut iteration = 0;
+
+    let progress = TimeProgress::new(
+        |iteration: usize| {
+            info!("Iteration {}", iteration);
+        },
+        1,
+    );
+
+    while todo.satisfiable() {
+        let mut todo1 = manager_ref.with_manager_shared(|manager| BDDFunction::f(manager));
+        for group in &groups {
+            // The native relational product: exists cur. (todo /\ relation).
+            let successors = todo.apply_exists(BooleanOperator::And, &group.relation, &current_cube)?;
+            todo1 = todo1.or(&successors.substitute(&rename)?)?;
+        }
+
+        todo = todo1.and(&states.not()?)?;
+        states = states.or(&todo)?;
+        progress.print(iteration);
+        iteration += 1;
+    }
+
+    // Count over all variables; the unconstrained next-state copies contribute
+    // a factor of exactly two to the number of assignments per state bit.
+    let mut cache: SatCountCache<u128, RandomState> = SatCountCache::default();
+    let count: u128 = states.sat_count(2 * encoding.state_bits, &mut cache);
+    Ok((count >> encoding.state_bits) as usize)
+}
+
+/// Converts a state set LDD into a BDD over the current-state variables of the
+/// given encoding, cf. [crate::ldd_to_bdd].
+fn ldd_set_to_bdd(
+    storage: &mut Storage,
+    manager_ref: &BDDManagerRef,
+    encoding: &BddEncoding,
+    set: &LddRef<'_>,
+    level: usize,
+) -> Result<BDDFunction, MercError> {
+    if **storage.empty_set() == *set {
+        return Ok(manager_ref.with_manager_shared(|manager| BDDFunction::f(manager)));
+    }
+    if **storage.empty_vector() == *set {
+        return Ok(manager_ref.with_manager_shared(|manager| BDDFunction::t(manager)));
+    }
+
+    let DataRef(value, down, right) = storage.get_ref(set);
+
+    let right = ldd_set_to_bdd(storage, manager_ref, encoding, &right, level)?;
+    let down = ldd_set_to_bdd(storage, manager_ref, encoding, &down, level + 1)?;
+    let down = encoding.encode_value(down, level, value, false)?;
+
+    Ok(down.or(&right)?)
+}
+
+/// Converts a sparse transition relation LDD into a total bit-blasted BDD
+/// relation, guided by the meta information of [merc_ldd::relational_product].
+///
+/// Read values constrain the current-state bits, written values constrain the
+/// next-state bits, and levels that are not part of the relation are closed
+/// off with identities so that the relational product preserves them.
+fn ldd_rel_to_bdd(
+    storage: &mut Storage,
+    manager_ref: &BDDManagerRef,
+    encoding: &BddEncoding,
+    identity_suffix: &[BDDFunction],
+    rel: &LddRef<'_>,
+    meta: &LddRef<'_>,
+    level: usize,
+) -> Result<BDDFunction, MercError> {
+    if **storage.empty_set() == *rel {
+        return Ok(manager_ref.with_manager_shared(|manager| BDDFunction::f(manager)));
+    }
+    if **storage.empty_vector() == *meta || **storage.empty_vector() == *rel {
+        // The remaining levels are not part of the relation and stay unchanged.
+        return Ok(identity_suffix[level].clone());
+    }
+
+    let DataRef(meta_value, meta_down, _) = storage.get_ref(meta);
+
+    match meta_value {
+        0 => {
+            // Not part of the relation; this level stays unchanged.
+            let down = ldd_rel_to_bdd(storage, manager_ref, encoding, identity_suffix, rel, &meta_down, level + 1)?;
+            Ok(encoding.identity_level(manager_ref, level)?.and(&down)?)
+        }
+        1 => {
+            // Read only; the value matches the current state and stays unchanged.
+            let DataRef(value, down, right) = storage.get_ref(rel);
+
+            let right = ldd_rel_to_bdd(storage, manager_ref, encoding, identity_suffix, &right, meta, level)?;
+            let down = ldd_rel_to_bdd(storage, manager_ref, encoding, identity_suffix, &down, &meta_down, level + 1)?;
+
+            let mut cube = encoding.encode_value(down, level, value, false)?;
+            cube = encoding.encode_value(cube, level, value, true)?;
+            Ok(cube.or(&right)?)
+        }
+        2 | 4 => {
+            // Write (phase); the value constrains the next state only.
+            let DataRef(value, down, right) = storage.get_ref(rel);
+
+            let right = ldd_rel_to_bdd(storage, manager_ref, encoding, identity_suffix, &right, meta, level)?;
+            let down = ldd_rel_to_bdd(storage, manager_ref, encoding, identity_suffix, &down, &meta_down, level + 1)?;
+
+            let cube = encoding.encode_value(down, level, value, true)?;
+            Ok(cube.or(&right)?)
+        }
+        3 => {
+            // Read phase of a read-write level; the write phase follows on the
+            // same level of the state vector.
+            let DataRef(value, down, right) = storage.get_ref(rel);
+
+            let right = ldd_rel_to_bdd(storage, manager_ref, encoding, identity_suffix, &right, meta, level)?;
+            let down = ldd_rel_to_bdd(storage, manager_ref, encoding, identity_suffix, &down, &meta_down, level)?;
+
+            let cube = encoding.encode_value(down, level, value, false)?;
+            Ok(cube.or(&right)?)
+        }
+        _ => Err(format!("Unexpected meta value {meta_value}").into()),
+    }
+}
+
+/// Computes the highest value for every layer of a state set LDD.
+fn compute_highest(storage: &mut Storage, ldd: &LddRef<'_>) -> Vec<u32> {
+    let mut result = vec![0; height(storage, ldd)];
+    compute_highest_rec(storage, &mut result, ldd, 0);
+    result
+}
+
+/// Helper function for [compute_highest].
+fn compute_highest_rec(storage: &mut Storage, result: &mut [u32], set: &LddRef<'_>, depth: usize) {
+    if set == storage.empty_set() || set == storage.empty_vector() {
+        return;
+    }
+
+    let DataRef(value, down, right) = storage.get_ref(set);
+    compute_highest_rec(storage, result, &right, depth);
+    compute_highest_rec(storage, result, &down, depth + 1);
+
+    result[depth] = result[depth].max(value);
+}
+
+/// Updates the highest value per level with the values that occur in the given
+/// sparse transition relation, mapping the relation levels to state vector
+/// levels through the meta information.
+fn compute_highest_rel(storage: &mut Storage, result: &mut [u32], rel: &LddRef<'_>, meta: &LddRef<'_>, level: usize) {
+    if rel == storage.empty_set() || rel == storage.empty_vector() || meta == storage.empty_vector() {
+        return;
+    }
+
+    let DataRef(meta_value, meta_down, _) = storage.get_ref(meta);
+
+    if meta_value == 0 {
+        // Not part of the relation; only the meta advances to the next level.
+        compute_highest_rel(storage, result, rel, &meta_down, level + 1);
+        return;
+    }
+
+    let DataRef(value, down, right) = storage.get_ref(rel);
+
+    compute_highest_rel(storage, result, &right, meta, level);
+
+    // The read phase of a read-write level (3) stays on the same state level.
+    let next_level = if meta_value == 3 { level } else { level + 1 };
+    compute_highest_rel(storage, result, &down, &meta_down, next_level);
+
+    if level < result.len() {
+        result[level] = result[level].max(value);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use merc_ldd::Storage;
+
+    use super::*;
+    use crate::ReachabilityStrategy;
+    use crate::reachability_with_strategy;
+    use crate::read_sylvan;
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Oxidd does not work with miri
+    fn test_reachability_bdd_agrees_with_ldd() {
+        let mut storage = Storage::new();
+        let bytes = include_bytes!("../../../examples/ldd/anderson.4.ldd");
+        let lts = read_sylvan(&mut storage, &mut &bytes[..]).expect("Loading should work correctly");
+
+        let expected = reachability_with_strategy(&mut storage, &lts, ReachabilityStrategy::Bfs)
+            .expect("Reachability should work correctly");
+
+        let manager_ref = oxidd::bdd::new_manager(1 << 20, 1 << 18, 1);
+        let result = reachability_bdd(&mut storage, &manager_ref, &lts).expect("Reachability should work correctly");
+
+        assert_eq!(result, expected, "The BDD reachability must explore the same state space");
+    }
+}
@@ -1,4 +1,5 @@
 use std::io::Read;
+use std::path::Path;
 
 use log::info;
 use merc_ldd::Ldd;
@@ -12,6 +13,17 @@ use merc_utilities::MercError;
 use crate::SymbolicLTS;
 use crate::TransitionGroup;
 
+/// Loads a symbolic state space in Sylvan's format from the given path, see
+/// [read_sylvan] for the description of the format.
+///
+/// Reads the complete file into memory up front such that the node arrays are
+/// decoded from a byte slice instead of through many small buffered reads.
+pub fn read_sylvan_file(storage: &mut Storage, path: &Path) -> Result<SylvanLts, MercError> {
+    let bytes = std::fs::read(path)?;
+
+    read_sylvan(storage, &mut &bytes[..])
+}
+
 /// Returns the (initial state, transitions) read from the file in Sylvan's format.
 pub fn read_sylvan(storage: &mut Storage, stream: &mut impl Read) -> Result<SylvanLts, MercError> {
     info!("Reading symbolic LTS in Sylvan format...");
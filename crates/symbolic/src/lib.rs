@@ -1,5 +1,6 @@
 #![forbid(unsafe_code)]
 
+mod bdd_reachability;
 mod cube_iter;
 mod format;
 mod io;
@@ -10,6 +11,7 @@ mod random_bdd;
 mod reachability;
 mod symbolic_lts;
 
+pub use bdd_reachability::*;
 pub use cube_iter::*;
 pub use format::*;
 pub use io::*;
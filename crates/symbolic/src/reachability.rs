@@ -28,6 +28,31 @@ pub trait TransitionGroup {
     fn meta(&self) -> &Ldd;
 }
 
+/// The exploration strategy used by [reachability_with_strategy].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "clap", derive(clap::ValueEnum))]
+pub enum ReachabilityStrategy {
+    /// Standard breadth-first search; every transition group is applied to the full todo set each iteration.
+    Bfs,
+    /// Chaining; within an iteration every transition group is applied to the accumulated todo set.
+    Chaining,
+    /// Saturation; transition groups are fired in dependency order with per-group fixpoints.
+    Saturation,
+}
+
+/// Performs reachability analysis using the given strategy. Returns the number of reachable states.
+pub fn reachability_with_strategy(
+    storage: &mut Storage,
+    lts: &impl SymbolicLTS,
+    strategy: ReachabilityStrategy,
+) -> Result<usize, MercError> {
+    match strategy {
+        ReachabilityStrategy::Bfs => reachability(storage, lts),
+        ReachabilityStrategy::Chaining => reachability_chaining(storage, lts),
+        ReachabilityStrategy::Saturation => reachability_saturation(storage, lts),
+    }
+}
+
 /// Performs reachability analysis using the given initial state and transitions read from a Sylvan file.
 pub fn reachability(storage: &mut Storage, lts: &impl SymbolicLTS) -> Result<usize, MercError> {
     let mut todo = lts.initial_state().clone();
@@ -56,3 +81,133 @@ pub fn reachability(storage: &mut Storage, lts: &impl SymbolicLTS) -> Result<usi
 
     Ok(len(storage, &states))
 }
+
+/// Performs reachability analysis using the chaining strategy.
+///
+/// Instead of applying every transition group to the todo set at the start of
+/// the iteration, states discovered by earlier groups are immediately visible
+/// to later groups. This typically reduces the number of iterations compared
+/// to breadth-first search.
+fn reachability_chaining(storage: &mut Storage, lts: &impl SymbolicLTS) -> Result<usize, MercError> {
+    let mut todo = lts.initial_state().clone();
+    let mut states = lts.initial_state().clone(); // The state space.
+    let mut iteration = 0;
+
+    let progress = TimeProgress::new(
+        |iteration: usize| {
+            info!("Iteration {}", iteration);
+        },
+        1,
+    );
+
+    while todo != *storage.empty_set() {
+        for transition in lts.transition_groups() {
+            let result = relational_product(storage, &todo, transition.relation(), transition.meta());
+            todo = union(storage, &todo, &result);
+        }
+
+        todo = minus(storage, &todo, &states);
+        states = union(storage, &states, &todo);
+        progress.print(iteration);
+        iteration += 1;
+    }
+
+    Ok(len(storage, &states))
+}
+
+/// Performs reachability analysis using the saturation strategy, cf. the
+/// saturation-like strategies of LTSmin and Sylvan.
+///
+/// Transition groups are ordered by the first state vector level that they
+/// depend on. For every group, in order, the set of states is saturated by
+/// applying that group together with all groups that depend on earlier levels
+/// until a fixpoint is reached. This keeps the intermediate LDDs small since
+/// lower levels are fully explored before higher levels are considered.
+fn reachability_saturation(storage: &mut Storage, lts: &impl SymbolicLTS) -> Result<usize, MercError> {
+    // Order the transition groups by the first level that occurs in their dependencies.
+    let groups = lts.transition_groups();
+    let mut order: Vec<usize> = (0..groups.len()).collect();
+    let levels: Vec<usize> = groups
+        .iter()
+        .map(|group| first_dependent_level(storage, group.meta()))
+        .collect();
+    order.sort_by_key(|&index| levels[index]);
+
+    let mut states = lts.initial_state().clone(); // The state space.
+    let mut round = 0;
+
+    let progress = TimeProgress::new(
+        |round: usize| {
+            info!("Saturating group {}", round);
+        },
+        1,
+    );
+
+    for position in 0..order.len() {
+        // Saturate with all groups up to and including the current one until a fixpoint is reached.
+        let mut todo = states.clone();
+
+        while todo != *storage.empty_set() {
+            let mut todo1 = storage.empty_set().clone();
+            for &index in &order[0..=position] {
+                let group = &groups[index];
+                let result = relational_product(storage, &todo, group.relation(), group.meta());
+                todo1 = union(storage, &todo1, &result);
+            }
+
+            todo = minus(storage, &todo1, &states);
+            states = union(storage, &states, &todo);
+        }
+
+        progress.print(round);
+        round += 1;
+    }
+
+    Ok(len(storage, &states))
+}
+
+/// Returns the first level of the state vector on which the given meta LDD
+/// depends, i.e., the first level that is read or written. Groups without any
+/// dependencies are saturated last.
+fn first_dependent_level(storage: &mut Storage, meta: &Ldd) -> usize {
+    let mut level = 0;
+    let mut current = meta.clone();
+
+    while current != *storage.empty_vector() && current != *storage.empty_set() {
+        let data = storage.get(&current);
+        if data.0 != 0 {
+            return level;
+        }
+
+        level += 1;
+        current = data.1;
+    }
+
+    usize::MAX
+}
+
+#[cfg(test)]
+mod tests {
+    use merc_ldd::Storage;
+
+    use super::*;
+    use crate::read_sylvan;
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Miri is too slow
+    fn test_reachability_strategies_agree() {
+        let mut storage = Storage::new();
+        let bytes = include_bytes!("../../../examples/ldd/anderson.4.ldd");
+        let lts = read_sylvan(&mut storage, &mut &bytes[..]).expect("Loading should work correctly");
+
+        let bfs = reachability_with_strategy(&mut storage, &lts, ReachabilityStrategy::Bfs)
+            .expect("Reachability should work correctly");
+        let chaining = reachability_with_strategy(&mut storage, &lts, ReachabilityStrategy::Chaining)
+            .expect("Reachability should work correctly");
+        let saturation = reachability_with_strategy(&mut storage, &lts, ReachabilityStrategy::Saturation)
+            .expect("Reachability should work correctly");
+
+        assert_eq!(bfs, chaining, "Chaining must explore the same state space as BFS");
+        assert_eq!(bfs, saturation, "Saturation must explore the same state space as BFS");
+    }
+}
@@ -3,6 +3,7 @@
 
 mod consume;
 mod parse;
+mod parse_parallel;
 mod precedence;
 mod syntax_tree;
 mod syntax_tree_display;
@@ -0,0 +1,363 @@
+use rayon::ThreadPoolBuilder;
+use rayon::iter::IntoParallelRefIterator;
+use rayon::iter::ParallelIterator;
+
+use merc_utilities::MercError;
+
+use crate::DataExpr;
+use crate::ProcessExpr;
+use crate::Span;
+use crate::UntypedDataSpecification;
+use crate::UntypedProcessSpecification;
+use crate::VarDecl;
+
+impl UntypedProcessSpecification {
+    /// Parses the given mCRL2 specification with the given number of worker threads.
+    ///
+    /// The top-level sections (`sort`, `cons`, `map`, `eqn`, `act`, `glob`,
+    /// `proc` and `init`) of a specification are independent, so the input is
+    /// split at the section keywords and the sections are parsed in parallel.
+    /// The result, including the source spans, is identical to
+    /// [UntypedProcessSpecification::parse]. Whenever the input cannot be split
+    /// or a section fails to parse, the whole input is parsed sequentially such
+    /// that errors are reported with respect to the complete input as well.
+    pub fn parse_parallel(spec: &str, threads: usize) -> Result<UntypedProcessSpecification, MercError> {
+        if threads <= 1 {
+            return UntypedProcessSpecification::parse(spec);
+        }
+
+        let sections = split_top_level_sections(spec);
+        if sections.len() <= 1 {
+            return UntypedProcessSpecification::parse(spec);
+        }
+
+        let pool = ThreadPoolBuilder::new()
+            .num_threads(threads)
+            .build()
+            .expect("Failed to construct the worker thread pool");
+
+        let parsed: Result<Vec<UntypedProcessSpecification>, MercError> = pool.install(|| {
+            sections
+                .par_iter()
+                .map(|&(offset, section)| {
+                    let mut result = UntypedProcessSpecification::parse(section)?;
+
+                    // The sections were parsed in isolation, so shift the spans
+                    // to their location in the complete input.
+                    offset_process_specification(&mut result, offset);
+                    Ok(result)
+                })
+                .collect()
+        });
+
+        match parsed {
+            Ok(results) => match merge_specifications(results) {
+                Some(result) => Ok(result),
+                // Multiple init sections, reparse sequentially for the proper error.
+                None => UntypedProcessSpecification::parse(spec),
+            },
+            // Reparse sequentially such that the error refers to the complete input.
+            Err(_) => UntypedProcessSpecification::parse(spec),
+        }
+    }
+}
+
+/// The keywords that start a top-level section of a process specification.
+///
+/// `var` is included since it starts the variable declarations of an `eqn`
+/// section, to which it belongs.
+const SECTION_KEYWORDS: [&str; 9] = ["act", "cons", "eqn", "glob", "init", "map", "proc", "sort", "var"];
+
+/// Returns true iff the given byte can occur in an identifier.
+fn is_identifier_byte(byte: u8) -> bool {
+    byte.is_ascii_alphanumeric() || byte == b'_' || byte == b'\''
+}
+
+/// Splits the specification into its top-level sections, returning for every
+/// section its byte offset in the input. The text before the first section,
+/// which can only contain comments and whitespace, belongs to the first
+/// section.
+///
+/// The split is purely textual: section keywords are reserved so any occurrence
+/// outside of a comment starts a new section, except that an `eqn` keyword
+/// following a `var` keyword continues the same equation section.
+fn split_top_level_sections(spec: &str) -> Vec<(usize, &str)> {
+    let bytes = spec.as_bytes();
+
+    let mut keywords: Vec<(usize, &str)> = Vec::new();
+    let mut in_comment = false;
+    let mut index = 0;
+    while index < bytes.len() {
+        let byte = bytes[index];
+
+        if in_comment {
+            in_comment = byte != b'\n';
+            index += 1;
+            continue;
+        }
+
+        if byte == b'%' {
+            in_comment = true;
+            index += 1;
+            continue;
+        }
+
+        if is_identifier_byte(byte) && (index == 0 || !is_identifier_byte(bytes[index - 1])) {
+            // The start of an identifier or keyword, check for a section keyword.
+            if let Some(keyword) = SECTION_KEYWORDS.iter().copied().find(|keyword| {
+                spec[index..].starts_with(keyword)
+                    && bytes.get(index + keyword.len()).is_none_or(|b| !is_identifier_byte(*b))
+            }) {
+                keywords.push((index, keyword));
+                index += keyword.len();
+                continue;
+            }
+        }
+
+        index += 1;
+    }
+
+    // An `eqn` keyword directly following a `var` keyword belongs to the same section.
+    let mut boundaries: Vec<usize> = Vec::with_capacity(keywords.len());
+    let mut previous_var = false;
+    for (position, keyword) in keywords {
+        if previous_var && keyword == "eqn" {
+            previous_var = false;
+            continue;
+        }
+
+        previous_var = keyword == "var";
+        boundaries.push(position);
+    }
+
+    if boundaries.is_empty() {
+        return vec![(0, spec)];
+    }
+
+    // Include the leading comments and whitespace in the first section.
+    boundaries[0] = 0;
+
+    let mut sections = Vec::with_capacity(boundaries.len());
+    for (i, &start) in boundaries.iter().enumerate() {
+        let end = boundaries.get(i + 1).copied().unwrap_or(spec.len());
+        sections.push((start, &spec[start..end]));
+    }
+
+    sections
+}
+
+/// Combines the specifications of the individual sections in order, or returns
+/// `None` when multiple sections declare an initial process.
+fn merge_specifications(results: Vec<UntypedProcessSpecification>) -> Option<UntypedProcessSpecification> {
+    let mut merged = UntypedProcessSpecification::default();
+
+    for mut result in results {
+        merged
+            .data_specification
+            .sort_declarations
+            .append(&mut result.data_specification.sort_declarations);
+        merged
+            .data_specification
+            .constructor_declarations
+            .append(&mut result.data_specification.constructor_declarations);
+        merged
+            .data_specification
+            .map_declarations
+            .append(&mut result.data_specification.map_declarations);
+        merged
+            .data_specification
+            .equation_declarations
+            .append(&mut result.data_specification.equation_declarations);
+        merged.global_variables.append(&mut result.global_variables);
+        merged.action_declarations.append(&mut result.action_declarations);
+        merged.process_declarations.append(&mut result.process_declarations);
+
+        if let Some(init) = result.init {
+            if merged.init.is_some() {
+                return None;
+            }
+
+            merged.init = Some(init);
+        }
+    }
+
+    Some(merged)
+}
+
+/// Shifts every span in the specification by the given offset.
+fn offset_process_specification(spec: &mut UntypedProcessSpecification, offset: usize) {
+    offset_data_specification(&mut spec.data_specification, offset);
+
+    for variable in &mut spec.global_variables {
+        offset_var_decl(variable, offset);
+    }
+
+    for action in &mut spec.action_declarations {
+        offset_span(&mut action.span, offset);
+    }
+
+    for process in &mut spec.process_declarations {
+        offset_span(&mut process.span, offset);
+        for param in &mut process.params {
+            offset_var_decl(param, offset);
+        }
+        offset_process_expr(&mut process.body, offset);
+    }
+
+    if let Some(init) = &mut spec.init {
+        offset_process_expr(init, offset);
+    }
+}
+
+/// Shifts every span in the data specification by the given offset.
+fn offset_data_specification(spec: &mut UntypedDataSpecification, offset: usize) {
+    for sort in &mut spec.sort_declarations {
+        offset_span(&mut sort.span, offset);
+    }
+
+    for constructor in &mut spec.constructor_declarations {
+        offset_span(&mut constructor.span, offset);
+    }
+
+    for map in &mut spec.map_declarations {
+        offset_span(&mut map.span, offset);
+    }
+
+    for equations in &mut spec.equation_declarations {
+        for variable in &mut equations.variables {
+            offset_var_decl(variable, offset);
+        }
+
+        for equation in &mut equations.equations {
+            offset_span(&mut equation.span, offset);
+            if let Some(condition) = &mut equation.condition {
+                offset_data_expr(condition, offset);
+            }
+            offset_data_expr(&mut equation.lhs, offset);
+            offset_data_expr(&mut equation.rhs, offset);
+        }
+    }
+}
+
+fn offset_span(span: &mut Span, offset: usize) {
+    span.start += offset;
+    span.end += offset;
+}
+
+fn offset_var_decl(decl: &mut VarDecl, offset: usize) {
+    // Sort expressions contain no spans.
+    offset_span(&mut decl.span, offset);
+}
+
+/// Shifts every span in the data expression by the given offset.
+fn offset_data_expr(expr: &mut DataExpr, offset: usize) {
+    match expr {
+        DataExpr::Id(_)
+        | DataExpr::Number(_)
+        | DataExpr::Bool(_)
+        | DataExpr::EmptyList
+        | DataExpr::EmptySet
+        | DataExpr::EmptyBag => {}
+        DataExpr::Application { function, arguments } => {
+            offset_data_expr(function, offset);
+            for argument in arguments {
+                offset_data_expr(argument, offset);
+            }
+        }
+        DataExpr::List(elements) | DataExpr::Set(elements) => {
+            for element in elements {
+                offset_data_expr(element, offset);
+            }
+        }
+        DataExpr::Bag(elements) => {
+            for element in elements {
+                offset_data_expr(&mut element.expr, offset);
+                offset_data_expr(&mut element.multiplicity, offset);
+            }
+        }
+        DataExpr::SetBagComp { variable, predicate } => {
+            offset_var_decl(variable, offset);
+            offset_data_expr(predicate, offset);
+        }
+        DataExpr::Lambda { variables, body } | DataExpr::Quantifier { variables, body, .. } => {
+            for variable in variables {
+                offset_var_decl(variable, offset);
+            }
+            offset_data_expr(body, offset);
+        }
+        DataExpr::Unary { expr, .. } => {
+            offset_data_expr(expr, offset);
+        }
+        DataExpr::Binary { lhs, rhs, .. } => {
+            offset_data_expr(lhs, offset);
+            offset_data_expr(rhs, offset);
+        }
+        DataExpr::FunctionUpdate { expr, update } => {
+            offset_data_expr(expr, offset);
+            offset_data_expr(&mut update.expr, offset);
+            offset_data_expr(&mut update.update, offset);
+        }
+        DataExpr::Whr { expr, assignments } => {
+            offset_data_expr(expr, offset);
+            for assignment in assignments {
+                offset_data_expr(&mut assignment.expr, offset);
+            }
+        }
+    }
+}
+
+/// Shifts every span in the process expression by the given offset.
+fn offset_process_expr(expr: &mut ProcessExpr, offset: usize) {
+    match expr {
+        ProcessExpr::Delta | ProcessExpr::Tau => {}
+        ProcessExpr::Id(_, assignments) => {
+            for assignment in assignments {
+                offset_data_expr(&mut assignment.expr, offset);
+            }
+        }
+        ProcessExpr::Action(_, arguments) => {
+            for argument in arguments {
+                offset_data_expr(argument, offset);
+            }
+        }
+        ProcessExpr::Sum { variables, operand } => {
+            for variable in variables {
+                offset_var_decl(variable, offset);
+            }
+            offset_process_expr(operand, offset);
+        }
+        ProcessExpr::Dist {
+            variables,
+            expr,
+            operand,
+        } => {
+            for variable in variables {
+                offset_var_decl(variable, offset);
+            }
+            offset_data_expr(expr, offset);
+            offset_process_expr(operand, offset);
+        }
+        ProcessExpr::Binary { lhs, rhs, .. } => {
+            offset_process_expr(lhs, offset);
+            offset_process_expr(rhs, offset);
+        }
+        ProcessExpr::Hide { operand, .. }
+        | ProcessExpr::Rename { operand, .. }
+        | ProcessExpr::Allow { operand, .. }
+        | ProcessExpr::Block { operand, .. }
+        | ProcessExpr::Comm { operand, .. } => {
+            offset_process_expr(operand, offset);
+        }
+        ProcessExpr::Condition { condition, then, else_ } => {
+            offset_data_expr(condition, offset);
+            offset_process_expr(then, offset);
+            if let Some(else_) = else_ {
+                offset_process_expr(else_, offset);
+            }
+        }
+        ProcessExpr::At { expr, operand } => {
+            offset_process_expr(expr, offset);
+            offset_data_expr(operand, offset);
+        }
+    }
+}
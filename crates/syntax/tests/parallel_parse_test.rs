@@ -0,0 +1,62 @@
+use indoc::indoc;
+use test_case::test_case;
+
+use merc_syntax::UntypedProcessSpecification;
+use merc_utilities::test_logger;
+
+#[cfg_attr(miri, ignore)]
+#[test_case(include_str!("../../../examples/mCRL2/academic/abp/abp.mcrl2") ; "abp.mcrl2")]
+#[test_case(include_str!("../../../examples/mCRL2/academic/bakery/bakery.mcrl2") ; "bakery.mcrl2")]
+#[test_case(include_str!("../../../examples/mCRL2/academic/bke/bke.mcrl2") ; "bke.mcrl2")]
+#[test_case(include_str!("../../../examples/mCRL2/academic/commprot/commprot.mcrl2") ; "commprot.mcrl2")]
+#[test_case(include_str!("../../../examples/mCRL2/academic/food_distribution/food_package.mcrl2") ; "food_package.mcrl2")]
+#[test_case(include_str!("../../../examples/mCRL2/academic/leader/dolev_klawe_rodeh.mcrl2") ; "dolev_klawe_rodeh.mcrl2")]
+fn test_parallel_parse_examples(spec: &str) {
+    test_logger();
+
+    let expected = UntypedProcessSpecification::parse(spec).unwrap();
+    let result = UntypedProcessSpecification::parse_parallel(spec, 4).unwrap();
+
+    // Equality includes the source spans, so this also checks that the spans
+    // refer to the complete input instead of the individual sections.
+    assert_eq!(result, expected);
+}
+
+#[test]
+fn test_parallel_parse_sections() {
+    test_logger();
+
+    // Section keywords inside comments must not split the input, and a var
+    // section belongs to the following eqn section.
+    let spec = indoc! {"
+        % A specification with an eqn keyword in this comment.
+        sort D = struct d1 | d2;
+
+        map f: D -> D;
+
+        var d: D; % proc
+        eqn f(d) = d;
+
+        act a: D;
+
+        init a(d1) . a(f(d2));
+    "};
+
+    let expected = UntypedProcessSpecification::parse(spec).unwrap();
+    let result = UntypedProcessSpecification::parse_parallel(spec, 4).unwrap();
+
+    assert_eq!(result, expected);
+}
+
+#[test]
+fn test_parallel_parse_error() {
+    test_logger();
+
+    // Errors are reported with respect to the complete input.
+    let spec = "sort D = struct d1 | d2;\n\nact a: Undefined ->;\n";
+
+    let expected = UntypedProcessSpecification::parse(spec).unwrap_err();
+    let result = UntypedProcessSpecification::parse_parallel(spec, 4).unwrap_err();
+
+    assert_eq!(format!("{result}"), format!("{expected}"));
+}
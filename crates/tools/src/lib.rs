@@ -1,7 +1,9 @@
 pub mod console;
+pub mod metrics;
 pub mod verbosity;
 pub mod version;
 
 pub use console::*;
+pub use metrics::*;
 pub use verbosity::*;
 pub use version::*;
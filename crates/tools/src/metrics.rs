@@ -0,0 +1,40 @@
+use std::io;
+
+use clap::Args;
+
+use merc_utilities::MercError;
+use merc_utilities::enable_metrics;
+use merc_utilities::write_metrics_json;
+
+/// The common `--metrics` flag for collecting performance metrics, see
+/// [merc_utilities::count] and [merc_utilities::start_timer].
+#[derive(Args, Debug)]
+pub struct MetricsFlag {
+    #[arg(
+        long,
+        global = true,
+        default_value_t = false,
+        help = "Collect performance metrics and write them as JSON to standard error"
+    )]
+    metrics: bool,
+}
+
+impl MetricsFlag {
+    /// Enables the collection of metrics when requested, to be called before
+    /// the tool performs any work.
+    pub fn enable(&self) {
+        if self.metrics {
+            enable_metrics();
+        }
+    }
+
+    /// Writes the collected metrics to standard error when requested, to be
+    /// called after the tool has finished its work.
+    pub fn finish(&self, tool_name: &str) -> Result<(), MercError> {
+        if self.metrics {
+            write_metrics_json(tool_name, &mut io::stderr().lock())?;
+        }
+
+        Ok(())
+    }
+}
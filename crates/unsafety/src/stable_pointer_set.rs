@@ -9,6 +9,8 @@ use std::ptr::NonNull;
 use std::ptr::addr_eq;
 #[cfg(debug_assertions)]
 use std::sync::Arc;
+use std::sync::atomic::AtomicUsize;
+use std::sync::atomic::Ordering;
 
 use allocator_api2::alloc::Allocator;
 use allocator_api2::alloc::Global;
@@ -375,6 +377,31 @@ where
         }
     }
 
+    /// Removes an element as part of a sweep that removes multiple elements.
+    ///
+    /// Unlike [StablePointerSet::remove] the element may still be referenced
+    /// from other elements that are removed in the same sweep, so no reference
+    /// count check is performed.
+    ///
+    /// # Safety
+    ///
+    /// The caller must ensure that all remaining references to the element are
+    /// dropped without being dereferenced.
+    pub unsafe fn remove_sweep(&self, pointer: StablePointer<T>) -> bool {
+        let t = pointer.deref();
+        let result = self.index.remove(&LookUp(t));
+
+        if let Some(ptr) = result {
+            // SAFETY: The element is unreachable after the sweep, so it is safe to remove it.
+            unsafe {
+                self.drop_and_deallocate_entry(ptr.ptr);
+            }
+            true
+        } else {
+            false
+        }
+    }
+
     /// Retains only the elements specified by the predicate, modifying the set in-place.
     ///
     /// The predicate closure is called with a mutable reference to each element and must
@@ -518,6 +545,74 @@ where
     }
 }
 
+impl<T: ?Sized, S, A> StablePointerSet<T, S, A>
+where
+    T: Hash + Eq + SliceDst + Send + Sync,
+    S: BuildHasher + Clone + Sync,
+    A: Allocator + AllocatorDst + Sync,
+{
+    /// Returns the number of independently locked shards of the set.
+    pub fn num_of_shards(&self) -> usize {
+        self.index.shards().len()
+    }
+
+    /// Same as [StablePointerSet::retain], but sweeps the shards of the set
+    /// with the given number of worker threads.
+    ///
+    /// The shards are independently locked, so the workers claim and sweep
+    /// them without synchronising on the elements. The predicate is called
+    /// exactly once for every element, but the order in which the elements of
+    /// different shards are visited depends on the interleaving of the
+    /// workers.
+    ///
+    /// # Safety
+    ///
+    /// It invalidates any StablePointers to removed elements
+    pub fn retain_parallel<F>(&self, threads: usize, predicate: F)
+    where
+        F: Fn(&StablePointer<T>) -> bool + Sync,
+    {
+        if threads <= 1 {
+            self.retain(|element| predicate(element));
+            return;
+        }
+
+        let shards = self.index.shards();
+        let next_shard = AtomicUsize::new(0);
+
+        std::thread::scope(|scope| {
+            for _ in 0..threads.min(shards.len()) {
+                scope.spawn(|| {
+                    loop {
+                        // Claim the next shard that has not been swept yet.
+                        let shard_index = next_shard.fetch_add(1, Ordering::Relaxed);
+                        if shard_index >= shards.len() {
+                            break;
+                        }
+
+                        let mut shard = shards[shard_index].write();
+                        shard.retain(|(element, ())| {
+                            let ptr = StablePointer::from_entry(element);
+
+                            if !predicate(&ptr) {
+                                // SAFETY: We have exclusive access to the
+                                // shard during the sweep and the pointer is
+                                // valid.
+                                unsafe {
+                                    self.drop_and_deallocate_entry(ptr.ptr);
+                                }
+                                return false;
+                            }
+
+                            true
+                        });
+                    }
+                });
+            }
+        });
+    }
+}
+
 impl<T, S, A> StablePointerSet<T, S, A>
 where
     T: Hash + Eq + SliceDst,
@@ -822,6 +917,26 @@ mod tests {
         assert!(set.remove(ptr4));
     }
 
+    #[test]
+    fn test_stable_pointer_set_retain_parallel() {
+        let set = StablePointerSet::new();
+
+        // Insert enough values to populate multiple shards.
+        for value in 0..1024 {
+            set.insert(value);
+        }
+        assert_eq!(set.len(), 1024);
+        assert!(set.num_of_shards() > 1);
+
+        // Retain only even numbers with multiple workers.
+        set.retain_parallel(4, |x| **x % 2 == 0);
+
+        assert_eq!(set.len(), 512);
+        for value in 0..1024 {
+            assert_eq!(set.contains(&value), value % 2 == 0);
+        }
+    }
+
     #[test]
     fn test_stable_pointer_set_custom_allocator() {
         // Test with System allocator
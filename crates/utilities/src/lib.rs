@@ -8,6 +8,7 @@ mod debug_trace;
 mod error;
 mod generational_index;
 mod helper;
+mod metrics;
 mod no_hasher;
 mod permutation;
 mod pest_display_pair;
@@ -19,6 +20,7 @@ mod timing;
 pub use error::*;
 pub use generational_index::*;
 pub use helper::*;
+pub use metrics::*;
 pub use no_hasher::*;
 pub use permutation::*;
 pub use pest_display_pair::*;
@@ -0,0 +1,227 @@
+use std::cell::RefCell;
+use std::collections::BTreeMap;
+use std::io;
+use std::io::Write;
+use std::sync::Mutex;
+use std::sync::atomic::AtomicBool;
+use std::sync::atomic::Ordering;
+use std::time::Instant;
+
+/// Whether metrics are being collected, disabled by default.
+static METRICS_ENABLED: AtomicBool = AtomicBool::new(false);
+
+/// The metrics of threads that have finished, merged on thread exit.
+static GLOBAL_METRICS: Mutex<Option<LocalMetrics>> = Mutex::new(None);
+
+thread_local! {
+    /// The metrics of the current thread, updated without synchronisation.
+    static LOCAL_METRICS: RefCell<ThreadMetrics> = RefCell::new(ThreadMetrics::default());
+}
+
+/// Enables the collection of metrics for all threads.
+///
+/// Metrics are disabled by default such that [count] and [start_timer] at hot
+/// paths only cost a single branch. Counters are kept per thread without any
+/// synchronisation and merged when the thread finishes, so metrics of worker
+/// threads are only visible in [write_metrics_json] after their pool has been
+/// dropped.
+pub fn enable_metrics() {
+    METRICS_ENABLED.store(true, Ordering::Relaxed);
+}
+
+/// Returns whether metrics are being collected.
+pub fn metrics_enabled() -> bool {
+    METRICS_ENABLED.load(Ordering::Relaxed)
+}
+
+/// Adds the given amount to the counter with the given name for this thread.
+pub fn count(name: &str, amount: u64) {
+    if !metrics_enabled() {
+        return;
+    }
+
+    LOCAL_METRICS.with_borrow_mut(|metrics| {
+        // Avoid allocating the name for the common case of an existing counter.
+        if let Some(counter) = metrics.0.counters.get_mut(name) {
+            *counter += amount;
+        } else {
+            metrics.0.counters.insert(name.to_string(), amount);
+        }
+    });
+}
+
+/// Adds a measurement in seconds to the timer with the given name for this thread.
+pub fn record_duration(name: &str, seconds: f64) {
+    if !metrics_enabled() {
+        return;
+    }
+
+    LOCAL_METRICS.with_borrow_mut(|metrics| {
+        if let Some(duration) = metrics.0.durations.get_mut(name) {
+            duration.record(seconds);
+        } else {
+            let mut duration = DurationMetric::default();
+            duration.record(seconds);
+            metrics.0.durations.insert(name.to_string(), duration);
+        }
+    });
+}
+
+/// Starts a timer that records the time until it is dropped under the given
+/// name, see [record_duration]. Does not measure anything when metrics are
+/// disabled.
+#[must_use]
+pub fn start_timer(name: &'static str) -> MetricsTimer {
+    MetricsTimer {
+        name,
+        start: metrics_enabled().then(Instant::now),
+    }
+}
+
+/// A timer for a single measurement, created by [start_timer].
+pub struct MetricsTimer {
+    name: &'static str,
+    start: Option<Instant>,
+}
+
+impl Drop for MetricsTimer {
+    fn drop(&mut self) {
+        if let Some(start) = self.start {
+            record_duration(self.name, start.elapsed().as_secs_f64());
+        }
+    }
+}
+
+/// Writes all collected metrics as a JSON object to the given writer.
+///
+/// Includes the metrics of the current thread and of all threads that have
+/// finished. Counter and timer names are emitted in alphabetical order.
+pub fn write_metrics_json(tool_name: &str, writer: &mut impl Write) -> io::Result<()> {
+    let mut merged = GLOBAL_METRICS
+        .lock()
+        .expect("Failed to lock the global metrics")
+        .clone()
+        .unwrap_or_default();
+    LOCAL_METRICS.with_borrow(|metrics| merged.merge(&metrics.0));
+
+    writeln!(writer, "{{")?;
+    writeln!(writer, "  \"tool\": \"{tool_name}\",")?;
+
+    writeln!(writer, "  \"counters\": {{")?;
+    for (i, (name, amount)) in merged.counters.iter().enumerate() {
+        let separator = if i + 1 < merged.counters.len() { "," } else { "" };
+        writeln!(writer, "    \"{name}\": {amount}{separator}")?;
+    }
+    writeln!(writer, "  }},")?;
+
+    writeln!(writer, "  \"timers\": {{")?;
+    for (i, (name, duration)) in merged.durations.iter().enumerate() {
+        let separator = if i + 1 < merged.durations.len() { "," } else { "" };
+        writeln!(
+            writer,
+            "    \"{name}\": {{ \"count\": {}, \"total\": {:.6}, \"min\": {:.6}, \"max\": {:.6}, \"avg\": {:.6} }}{separator}",
+            duration.count,
+            duration.total,
+            duration.min,
+            duration.max,
+            duration.total / duration.count as f64
+        )?;
+    }
+    writeln!(writer, "  }}")?;
+    writeln!(writer, "}}")
+}
+
+/// The counters and timers of a single thread.
+#[derive(Clone, Default)]
+struct LocalMetrics {
+    counters: BTreeMap<String, u64>,
+    durations: BTreeMap<String, DurationMetric>,
+}
+
+/// Aggregated measurements in seconds for a single timer.
+#[derive(Clone, Copy)]
+struct DurationMetric {
+    count: u64,
+    total: f64,
+    min: f64,
+    max: f64,
+}
+
+impl DurationMetric {
+    /// Adds a single measurement in seconds.
+    fn record(&mut self, seconds: f64) {
+        self.count += 1;
+        self.total += seconds;
+        self.min = self.min.min(seconds);
+        self.max = self.max.max(seconds);
+    }
+}
+
+impl Default for DurationMetric {
+    fn default() -> Self {
+        Self {
+            count: 0,
+            total: 0.0,
+            min: f64::INFINITY,
+            max: f64::NEG_INFINITY,
+        }
+    }
+}
+
+impl LocalMetrics {
+    /// Adds the counters and timers of the other metrics to this one.
+    fn merge(&mut self, other: &LocalMetrics) {
+        for (name, amount) in &other.counters {
+            *self.counters.entry(name.clone()).or_default() += amount;
+        }
+
+        for (name, duration) in &other.durations {
+            let entry = self.durations.entry(name.clone()).or_default();
+            entry.count += duration.count;
+            entry.total += duration.total;
+            entry.min = entry.min.min(duration.min);
+            entry.max = entry.max.max(duration.max);
+        }
+    }
+}
+
+/// The metrics of a single thread, merged into [GLOBAL_METRICS] on thread exit.
+#[derive(Default)]
+struct ThreadMetrics(LocalMetrics);
+
+impl Drop for ThreadMetrics {
+    fn drop(&mut self) {
+        // Merge the metrics of this thread when it finishes, ignoring a
+        // poisoned lock since this can run during a panic.
+        if let Ok(mut global) = GLOBAL_METRICS.lock() {
+            global.get_or_insert_with(LocalMetrics::default).merge(&self.0);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_metrics() {
+        enable_metrics();
+
+        count("test.counter", 2);
+        count("test.counter", 3);
+        record_duration("test.timer", 0.5);
+
+        std::thread::spawn(|| {
+            count("test.counter", 5);
+        })
+        .join()
+        .unwrap();
+
+        let mut output = Vec::new();
+        write_metrics_json("test", &mut output).unwrap();
+
+        let output = String::from_utf8(output).unwrap();
+        assert!(output.contains("\"test.counter\": 10"));
+        assert!(output.contains("\"count\": 1"));
+    }
+}
@@ -125,7 +125,8 @@ impl Timer {
         let time = self.start.elapsed().as_secs_f64();
         info!("Time {}: {:.3}s", self.name, time);
 
-        // Register the result.
+        // Register the result, also in the metrics when these are collected.
+        crate::record_duration(&self.name, time);
         self.results.borrow_mut().push((self.name.clone(), time as f32));
         self.registered = true
     }
@@ -4,6 +4,7 @@
 mod feature_transition_system;
 mod modal_equation_system;
 mod parity_games;
+mod pbes_instantiation;
 mod project;
 mod reachability;
 mod repeat;
@@ -11,10 +12,12 @@ mod submap;
 mod translate;
 mod variability_zielonka;
 mod zielonka;
+mod zielonka_parallel;
 
 pub use feature_transition_system::*;
 pub use modal_equation_system::*;
 pub use parity_games::*;
+pub use pbes_instantiation::*;
 pub use project::*;
 pub use reachability::*;
 pub use repeat::*;
@@ -22,3 +25,4 @@ pub use submap::*;
 pub use translate::*;
 pub use variability_zielonka::*;
 pub use zielonka::*;
+pub use zielonka_parallel::*;
@@ -0,0 +1,470 @@
+use log::trace;
+
+use merc_collections::IndexedSet;
+use merc_data::DataExpression;
+use merc_data::DataExpressionRef;
+use merc_data::DataVariable;
+use merc_data::DataVariableRef;
+use merc_data::is_data_variable;
+use merc_sabre::InnermostRewriter;
+use merc_sabre::RewriteEngine;
+use merc_sabre::RewriteSpecification;
+use merc_syntax::FixedPointOperator;
+
+use crate::ParityGame;
+use crate::Player;
+use crate::Priority;
+use crate::VertexIndex;
+
+/// A parameterised boolean equation system (PBES) in standard recursive form
+/// (SRF).
+///
+/// In SRF the right hand side of every equation `sigma X(d: D) = phi` is either
+/// a disjunction or a conjunction of summands `f_i(d) /\ X_i(g_i(d))`, where
+/// the condition `f_i` is a data expression over the equation parameters. This
+/// is the shape produced by `pbes_to_srf_pbes` in the mCRL2 toolset, and the
+/// input format of [instantiate_pbes].
+pub struct SrfPbes {
+    equations: Vec<SrfEquation>,
+    initial_variable: usize,
+    initial_arguments: Vec<DataExpression>,
+}
+
+/// Indicates whether the summands of an equation are combined with a
+/// disjunction or a conjunction.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum SrfOperand {
+    Disjunctive,
+    Conjunctive,
+}
+
+/// A single SRF equation `sigma X(d: D) = op_i f_i(d) /\ X_i(g_i(d))`.
+pub struct SrfEquation {
+    operator: FixedPointOperator,
+    name: String,
+    parameters: Vec<DataVariable>,
+    operand: SrfOperand,
+    summands: Vec<SrfSummand>,
+}
+
+/// A single summand `f(d) /\ X(g(d))` of an SRF equation.
+pub struct SrfSummand {
+    condition: DataExpression,
+    variable: usize,
+    arguments: Vec<DataExpression>,
+}
+
+impl SrfPbes {
+    /// Creates a new SRF PBES with the given equations and initial instance,
+    /// given by the index of an equation and its arguments.
+    pub fn new(equations: Vec<SrfEquation>, initial_variable: usize, initial_arguments: Vec<DataExpression>) -> Self {
+        debug_assert!(initial_variable < equations.len(), "Initial variable out of bounds");
+        debug_assert_eq!(
+            initial_arguments.len(),
+            equations[initial_variable].parameters.len(),
+            "Arity mismatch for the initial instance"
+        );
+        for equation in &equations {
+            for summand in &equation.summands {
+                debug_assert!(summand.variable < equations.len(), "Summand variable out of bounds");
+                debug_assert_eq!(
+                    summand.arguments.len(),
+                    equations[summand.variable].parameters.len(),
+                    "Arity mismatch in a summand of equation {}",
+                    equation.name
+                );
+            }
+        }
+
+        Self {
+            equations,
+            initial_variable,
+            initial_arguments,
+        }
+    }
+
+    /// Returns the equations of this PBES.
+    pub fn equations(&self) -> &[SrfEquation] {
+        &self.equations
+    }
+
+    /// Assigns a game priority to every equation.
+    ///
+    /// Equations are ranked by their alternation: the rank increases whenever
+    /// the fixed point operator changes, and least fixed points have odd ranks.
+    /// The parity games in this crate are max-priority games, so the ranks are
+    /// mirrored such that outer equations obtain the highest priorities while
+    /// keeping their parity.
+    fn priorities(&self) -> Vec<Priority> {
+        let mut ranks: Vec<usize> = Vec::with_capacity(self.equations.len());
+
+        let mut rank = match self.equations[0].operator {
+            FixedPointOperator::Greatest => 0,
+            FixedPointOperator::Least => 1,
+        };
+
+        let mut previous = self.equations[0].operator;
+        for equation in &self.equations {
+            if equation.operator != previous {
+                rank += 1;
+                previous = equation.operator;
+            }
+
+            ranks.push(rank);
+        }
+
+        // Mirror the ranks, using an even maximum to preserve the parity.
+        let highest = rank + rank % 2;
+        ranks.into_iter().map(|rank| Priority::new(highest - rank)).collect()
+    }
+}
+
+impl SrfEquation {
+    /// Creates a new SRF equation with the given operator, parameters and summands.
+    pub fn new(
+        operator: FixedPointOperator,
+        name: impl Into<String>,
+        parameters: Vec<DataVariable>,
+        operand: SrfOperand,
+        summands: Vec<SrfSummand>,
+    ) -> Self {
+        Self {
+            operator,
+            name: name.into(),
+            parameters,
+            operand,
+            summands,
+        }
+    }
+
+    /// Returns the name of the bound variable of this equation.
+    pub fn name(&self) -> &str {
+        &self.name
+    }
+}
+
+impl SrfSummand {
+    /// Creates a new summand with the given condition and the instance
+    /// `X(arguments)` of the equation with the given index.
+    pub fn new(condition: DataExpression, variable: usize, arguments: Vec<DataExpression>) -> Self {
+        Self {
+            condition,
+            variable,
+            arguments,
+        }
+    }
+}
+
+/// Instantiates the given SRF PBES into an explicit parity game, using the
+/// given rewrite system to evaluate the conditions and arguments.
+///
+/// Vertices are the reachable propositional variable instances `X(v)` with the
+/// arguments in normal form, interned such that every instance is explored
+/// once. A summand contributes an edge iff its condition rewrites to `true`
+/// under the equation parameters. Disjunctive equations are owned by player
+/// even and conjunctive equations by player odd, and the priority of a vertex
+/// is determined by the rank of its equation. Instances without any remaining
+/// edge obtain a self loop that is losing for the owner, so an empty
+/// disjunction is false and an empty conjunction is true.
+///
+/// The reachable instances are processed in breadth-first batches and their
+/// edges are streamed directly into the [ParityGame], without an intermediate
+/// boolean equation system. The instances of a batch are independent, so a
+/// batch can be distributed over workers with their own rewriter once terms
+/// can be shared between threads.
+pub fn instantiate_pbes(pbes: &SrfPbes, spec: &RewriteSpecification) -> ParityGame {
+    let mut algorithm = Instantiation {
+        pbes,
+        priorities: pbes.priorities(),
+        rewriter: InnermostRewriter::new(spec),
+        true_term: DataExpression::from_string("true").expect("the constant true can always be parsed"),
+        instances: IndexedSet::new(),
+        vertices: Vec::new(),
+        owner: Vec::new(),
+        priority: Vec::new(),
+        edges: Vec::new(),
+    };
+
+    algorithm.instantiate();
+
+    // Adding the self loops for empty disjunctions and conjunctions makes the game total.
+    ParityGame::from_edges(VertexIndex::new(0), algorithm.owner, algorithm.priority, true, || {
+        algorithm.edges.iter().copied()
+    })
+}
+
+/// Local struct to keep track of the instantiation state.
+struct Instantiation<'a> {
+    pbes: &'a SrfPbes,
+    priorities: Vec<Priority>,
+    rewriter: InnermostRewriter,
+
+    /// The normal form of the constant `true`, against which conditions are compared.
+    true_term: DataExpression,
+
+    /// Assigns consecutive vertex numbers to the discovered instances, with the
+    /// instance for every vertex stored in `vertices`.
+    instances: IndexedSet<(usize, Vec<DataExpression>)>,
+    vertices: Vec<(usize, Vec<DataExpression>)>,
+
+    owner: Vec<Player>,
+    priority: Vec<Priority>,
+    edges: Vec<(VertexIndex, VertexIndex)>,
+}
+
+impl Instantiation<'_> {
+    /// Explores all instances reachable from the initial instance in breadth-first batches.
+    fn instantiate(&mut self) {
+        // The initial instance is vertex 0, with its arguments in normal form.
+        let initial_arguments: Vec<DataExpression> = self
+            .pbes
+            .initial_arguments
+            .iter()
+            .map(|argument| self.rewriter.rewrite(argument))
+            .collect();
+
+        let mut batch: Vec<VertexIndex> = Vec::new();
+        let mut next_batch: Vec<VertexIndex> = Vec::new();
+        self.discover((self.pbes.initial_variable, initial_arguments), &mut batch);
+
+        while !batch.is_empty() {
+            for vertex in batch.drain(..) {
+                self.instantiate_vertex(vertex, &mut next_batch);
+            }
+
+            std::mem::swap(&mut batch, &mut next_batch);
+        }
+    }
+
+    /// Evaluates the summands of the given vertex and adds the resulting edges.
+    fn instantiate_vertex(&mut self, vertex: VertexIndex, batch: &mut Vec<VertexIndex>) {
+        let (equation_index, arguments) = self.vertices[vertex.value()].clone();
+        let equation = &self.pbes.equations[equation_index];
+
+        let substitution: Vec<(&DataVariable, &DataExpression)> =
+            equation.parameters.iter().zip(arguments.iter()).collect();
+
+        for summand in &equation.summands {
+            let condition = self
+                .rewriter
+                .rewrite(&substitute_variables(&summand.condition.copy(), &substitution));
+            if condition != self.true_term {
+                trace!(
+                    "Summand towards {} of {}({:?}) has condition {}",
+                    self.pbes.equations[summand.variable].name, equation.name, arguments, condition
+                );
+                continue;
+            }
+
+            let summand_arguments: Vec<DataExpression> = summand
+                .arguments
+                .iter()
+                .map(|argument| {
+                    self.rewriter
+                        .rewrite(&substitute_variables(&argument.copy(), &substitution))
+                })
+                .collect();
+
+            let to = self.discover((summand.variable, summand_arguments), batch);
+            self.edges.push((vertex, to));
+        }
+    }
+
+    /// Returns the vertex for the given instance, queueing it when it is new.
+    fn discover(&mut self, instance: (usize, Vec<DataExpression>), batch: &mut Vec<VertexIndex>) -> VertexIndex {
+        let (index, inserted) = self.instances.insert(instance.clone());
+        if inserted {
+            trace!(
+                "Discovered instance {}({:?})",
+                self.pbes.equations[instance.0].name, instance.1
+            );
+
+            self.owner.push(match self.pbes.equations[instance.0].operand {
+                SrfOperand::Disjunctive => Player::Even,
+                SrfOperand::Conjunctive => Player::Odd,
+            });
+            self.priority.push(self.priorities[instance.0]);
+            self.vertices.push(instance);
+            batch.push(VertexIndex::new(*index));
+        }
+
+        VertexIndex::new(*index)
+    }
+}
+
+/// Replaces every variable of the substitution by its value in the given term.
+fn substitute_variables(
+    term: &DataExpressionRef<'_>,
+    substitution: &[(&DataVariable, &DataExpression)],
+) -> DataExpression {
+    if is_data_variable(term) {
+        let variable = DataVariableRef::from(term.copy());
+        if let Some((_, value)) = substitution
+            .iter()
+            .find(|(parameter, _)| parameter.name() == variable.name())
+        {
+            return (*value).clone();
+        }
+
+        // Free variables are kept as is.
+        return term.protect();
+    }
+
+    let mut arguments: Vec<DataExpression> = Vec::new();
+    for argument in term.data_arguments() {
+        arguments.push(substitute_variables(&argument, substitution));
+    }
+
+    if arguments.is_empty() {
+        term.protect()
+    } else {
+        merc_data::DataApplication::with_args(&term.data_function_symbol(), &arguments).into()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use ahash::AHashSet;
+
+    use merc_sabre::test_utility::create_rewrite_rule;
+
+    use crate::PG;
+    use crate::solve_zielonka;
+
+    use super::*;
+
+    /// Returns the rewrite rules for equality and less-than on Peano numbers.
+    fn peano_specification() -> RewriteSpecification {
+        let rules = vec![
+            create_rewrite_rule("eq(zero, zero)", "true", &[]).unwrap(),
+            create_rewrite_rule("eq(s(N), s(M))", "eq(N, M)", &["N", "M"]).unwrap(),
+            create_rewrite_rule("eq(zero, s(N))", "false", &["N"]).unwrap(),
+            create_rewrite_rule("eq(s(N), zero)", "false", &["N"]).unwrap(),
+            create_rewrite_rule("lt(zero, s(N))", "true", &["N"]).unwrap(),
+            create_rewrite_rule("lt(N, zero)", "false", &["N"]).unwrap(),
+            create_rewrite_rule("lt(s(N), s(M))", "lt(N, M)", &["N", "M"]).unwrap(),
+        ];
+
+        RewriteSpecification::new(rules)
+    }
+
+    /// Parses a condition or argument over the parameter `n`.
+    fn expression(text: &str) -> DataExpression {
+        let variables = AHashSet::from_iter(["n".to_string()]);
+        DataExpression::from_string_untyped(text, &variables).unwrap()
+    }
+
+    #[test]
+    fn test_instantiate_pbes_boolean() {
+        // nu X = X is true, and mu Y = Y is false.
+        let pbes = SrfPbes::new(
+            vec![
+                SrfEquation::new(
+                    FixedPointOperator::Greatest,
+                    "X",
+                    vec![],
+                    SrfOperand::Conjunctive,
+                    vec![SrfSummand::new(expression("true"), 0, vec![])],
+                ),
+                SrfEquation::new(
+                    FixedPointOperator::Least,
+                    "Y",
+                    vec![],
+                    SrfOperand::Disjunctive,
+                    vec![SrfSummand::new(expression("true"), 1, vec![])],
+                ),
+            ],
+            0,
+            vec![],
+        );
+
+        let spec = RewriteSpecification::new(vec![]);
+        let game = instantiate_pbes(&pbes, &spec);
+        let [won_even, _] = solve_zielonka(&game);
+        assert!(won_even[0], "nu X = X should be true");
+
+        let pbes = SrfPbes::new(
+            vec![SrfEquation::new(
+                FixedPointOperator::Least,
+                "Y",
+                vec![],
+                SrfOperand::Disjunctive,
+                vec![SrfSummand::new(expression("true"), 0, vec![])],
+            )],
+            0,
+            vec![],
+        );
+
+        let game = instantiate_pbes(&pbes, &spec);
+        let [_, won_odd] = solve_zielonka(&game);
+        assert!(won_odd[0], "mu Y = Y should be false");
+    }
+
+    #[test]
+    fn test_instantiate_pbes_counter() {
+        // mu X(n) = eq(n, 2) /\ T or lt(n, 2) /\ X(s(n)), with nu T = T, which
+        // holds iff the instance can count up to two.
+        let equations = vec![
+            SrfEquation::new(
+                FixedPointOperator::Least,
+                "X",
+                vec![DataVariable::new("n")],
+                SrfOperand::Disjunctive,
+                vec![
+                    SrfSummand::new(expression("eq(n, s(s(zero)))"), 1, vec![]),
+                    SrfSummand::new(expression("lt(n, s(s(zero)))"), 0, vec![expression("s(n)")]),
+                ],
+            ),
+            SrfEquation::new(
+                FixedPointOperator::Greatest,
+                "T",
+                vec![],
+                SrfOperand::Conjunctive,
+                vec![SrfSummand::new(expression("true"), 1, vec![])],
+            ),
+        ];
+
+        let spec = peano_specification();
+
+        // From zero the chain X(0) -> X(1) -> X(2) -> T is found.
+        let pbes = SrfPbes::new(equations, 0, vec![expression("zero")]);
+        let game = instantiate_pbes(&pbes, &spec);
+
+        // The instances X(0), X(1), X(2) and T.
+        assert_eq!(game.num_of_vertices(), 4);
+
+        let [won_even, _] = solve_zielonka(&game);
+        assert!(won_even[0], "X(zero) should be true");
+    }
+
+    #[test]
+    fn test_instantiate_pbes_counter_unreachable() {
+        // The same counter, but starting beyond the bound so that X(3) has no
+        // true summand and is an empty disjunction.
+        let equations = vec![
+            SrfEquation::new(
+                FixedPointOperator::Least,
+                "X",
+                vec![DataVariable::new("n")],
+                SrfOperand::Disjunctive,
+                vec![
+                    SrfSummand::new(expression("eq(n, s(s(zero)))"), 1, vec![]),
+                    SrfSummand::new(expression("lt(n, s(s(zero)))"), 0, vec![expression("s(n)")]),
+                ],
+            ),
+            SrfEquation::new(
+                FixedPointOperator::Greatest,
+                "T",
+                vec![],
+                SrfOperand::Conjunctive,
+                vec![SrfSummand::new(expression("true"), 1, vec![])],
+            ),
+        ];
+
+        let pbes = SrfPbes::new(equations, 0, vec![expression("s(s(s(zero)))")]);
+        let game = instantiate_pbes(&pbes, &peano_specification());
+
+        let [_, won_odd] = solve_zielonka(&game);
+        assert!(won_odd[0], "X(s(s(s(zero)))) should be false");
+    }
+}
@@ -0,0 +1,301 @@
+#![allow(nonstandard_style)]
+//! To keep with the theory, we use capitalized variable names for sets of vertices.
+//!
+//! Implements the Zielonka recursive solver with a parallel attractor
+//! computation for explicit parity games.
+
+use std::ops::BitAnd;
+use std::sync::atomic::AtomicBool;
+use std::sync::atomic::AtomicU32;
+use std::sync::atomic::Ordering;
+
+use bitvec::bitvec;
+use bitvec::order::Lsb0;
+use log::debug;
+use rayon::ThreadPool;
+use rayon::ThreadPoolBuilder;
+use rayon::prelude::*;
+
+use crate::PG;
+use crate::ParityGame;
+use crate::Player;
+use crate::Predecessors;
+use crate::Priority;
+use crate::VertexIndex;
+use crate::combine;
+use crate::solve_zielonka;
+use crate::x_and_not_x;
+use crate::zielonka::Set;
+
+/// The number of vertices processed per work item in the parallel phases.
+const CHUNK_SIZE: usize = 4096;
+
+/// Solves the given parity game using the Zielonka algorithm, computing the
+/// attractors in parallel with the given number of worker threads.
+///
+/// The attractor is expanded frontier by frontier. Every round the predecessors
+/// of the current frontier are processed in batches across the worker threads.
+/// The forced-vertex test for opponent vertices uses an atomic counter of
+/// successors that are not yet attracted, so a vertex is attracted by exactly
+/// one worker when its last remaining successor enters the attractor. This
+/// yields the same attractor as the sequential breadth-first search.
+pub fn solve_zielonka_parallel(game: &ParityGame, threads: usize) -> [Set; 2] {
+    if threads <= 1 {
+        return solve_zielonka(game);
+    }
+
+    debug_assert!(game.is_total(), "Zielonka solver requires a total parity game");
+
+    let pool = ThreadPoolBuilder::new()
+        .num_threads(threads)
+        .build()
+        .expect("Failed to construct the worker thread pool");
+
+    let mut V = bitvec![usize, Lsb0; 0; game.num_of_vertices()];
+    V.set_elements(usize::MAX);
+    let full_V = V.clone(); // Used for debugging.
+
+    let mut zielonka = ZielonkaSolverParallel::new(game, pool);
+
+    let (W0, W1) = zielonka.zielonka_rec(V, 0);
+
+    // Check that the result is a valid partition
+    debug!("Performed {} recursive calls", zielonka.recursive_calls);
+    if cfg!(debug_assertions) {
+        zielonka.check_partition(&W0, &W1, &full_V);
+    }
+    [W0, W1]
+}
+
+struct ZielonkaSolverParallel<'a> {
+    game: &'a ParityGame,
+
+    /// The worker thread pool used for the attractor computation.
+    pool: ThreadPool,
+
+    /// Stores the predecessors of the game.
+    predecessors: Predecessors,
+
+    /// Temporary storage for vertices per priority.
+    priority_vertices: Vec<Vec<VertexIndex>>,
+
+    /// Per vertex counter of successors that are not yet in the attractor,
+    /// only meaningful for opponent vertices in the current subgame.
+    counters: Vec<AtomicU32>,
+
+    /// Per vertex flag whether it has been claimed into the attractor.
+    in_attractor: Vec<AtomicBool>,
+
+    /// Keeps track of the total number of recursive calls.
+    recursive_calls: usize,
+}
+
+impl ZielonkaSolverParallel<'_> {
+    /// Creates a new parallel Zielonka solver for the given parity game.
+    fn new<'a>(game: &'a ParityGame, pool: ThreadPool) -> ZielonkaSolverParallel<'a> {
+        // Keep track of the vertices for each priority
+        let mut priority_vertices = Vec::new();
+
+        for v in game.iter_vertices() {
+            let prio = game.priority(v);
+
+            while prio >= priority_vertices.len() {
+                priority_vertices.push(Vec::new());
+            }
+
+            priority_vertices[prio].push(v);
+        }
+
+        let mut counters = Vec::new();
+        counters.resize_with(game.num_of_vertices(), || AtomicU32::new(0));
+        let mut in_attractor = Vec::new();
+        in_attractor.resize_with(game.num_of_vertices(), || AtomicBool::new(false));
+
+        ZielonkaSolverParallel {
+            game,
+            pool,
+            predecessors: Predecessors::new(game),
+            priority_vertices,
+            counters,
+            in_attractor,
+            recursive_calls: 0,
+        }
+    }
+
+    /// Recursively solves the parity game for the given set of vertices V.
+    fn zielonka_rec(&mut self, V: Set, depth: usize) -> (Set, Set) {
+        self.recursive_calls += 1;
+        let full_V = V.clone(); // Used for debugging
+
+        if !V.any() {
+            return (V.clone(), V);
+        }
+
+        let (highest_prio, _lowest_prio) = self.get_highest_lowest_prio(&V);
+        let alpha = Player::from_priority(&highest_prio);
+        let not_alpha = alpha.opponent();
+
+        // Collect the set U of vertices with the highest priority in V
+        let mut U = bitvec![usize, Lsb0; 0; self.game.num_of_vertices()];
+        for &v in self.priority_vertices[highest_prio].iter() {
+            if V[*v] {
+                U.set(*v, true);
+            }
+        }
+
+        let A = self.attractor(alpha, &V, U);
+
+        let (W1_0, W1_1) = self.zielonka_rec(V.clone().bitand(!A.clone()), depth + 1);
+
+        let (mut W1_alpha, W1_not_alpha) = x_and_not_x(W1_0, W1_1, alpha);
+
+        if !W1_not_alpha.any() {
+            W1_alpha |= A;
+            combine(W1_alpha, W1_not_alpha, alpha)
+        } else {
+            let B = self.attractor(not_alpha, &V, W1_not_alpha);
+
+            let (W2_0, W2_1) = self.zielonka_rec(V.bitand(!B.clone()), depth + 1);
+
+            let (W2_alpha, mut W2_not_alpha) = x_and_not_x(W2_0, W2_1, alpha);
+
+            W2_not_alpha |= B;
+            self.check_partition(&W2_alpha, &W2_not_alpha, &full_V);
+            combine(W2_alpha, W2_not_alpha, alpha)
+        }
+    }
+
+    /// Computes the attractor for `alpha` to the set `A` within the vertices
+    /// `V`, expanding the frontier in parallel rounds.
+    fn attractor(&mut self, alpha: Player, V: &Set, mut A: Set) -> Set {
+        let game = self.game;
+        let predecessors = &self.predecessors;
+        let counters = &self.counters;
+        let in_attractor = &self.in_attractor;
+        let num_of_vertices = game.num_of_vertices();
+
+        // Initialise the claim flags from A and the counters with the number
+        // of successors inside the subgame V.
+        self.pool.install(|| {
+            (0..num_of_vertices.div_ceil(CHUNK_SIZE)).into_par_iter().for_each(|chunk| {
+                let begin = chunk * CHUNK_SIZE;
+                let end = (begin + CHUNK_SIZE).min(num_of_vertices);
+
+                for v in begin..end {
+                    in_attractor[v].store(A[v], Ordering::Relaxed);
+
+                    let vertex = VertexIndex::new(v);
+                    if V[v] && game.owner(vertex) != alpha {
+                        let successors = game.outgoing_edges(vertex).filter(|w| V[**w]).count();
+                        counters[v].store(successors as u32, Ordering::Relaxed);
+                    }
+                }
+            });
+        });
+
+        // 2. Q = {v \in A}
+        let mut frontier: Vec<VertexIndex> = A.iter_ones().map(VertexIndex::new).collect();
+
+        // 4. While Q is not empty process the whole frontier in one round.
+        while !frontier.is_empty() {
+            let next: Vec<VertexIndex> = self.pool.install(|| {
+                frontier
+                    .par_chunks(CHUNK_SIZE)
+                    .flat_map_iter(|batch| {
+                        let mut claimed = Vec::new();
+
+                        for &w in batch {
+                            // For every u \in Ew do
+                            for v in predecessors.predecessors(w) {
+                                if V[*v] && !in_attractor[*v].load(Ordering::Relaxed) {
+                                    let attracted = if game.owner(v) == alpha {
+                                        // v \in V and v in V_\alpha
+                                        true
+                                    } else {
+                                        // The last successor of v entered the attractor.
+                                        counters[*v].fetch_sub(1, Ordering::Relaxed) == 1
+                                    };
+
+                                    // The swap ensures that every vertex is claimed by one worker.
+                                    if attracted && !in_attractor[*v].swap(true, Ordering::Relaxed) {
+                                        claimed.push(v);
+                                    }
+                                }
+                            }
+                        }
+
+                        claimed
+                    })
+                    .collect()
+            });
+
+            // Merge the newly attracted vertices into the set sequentially.
+            for &v in &next {
+                A.set(*v, true);
+            }
+
+            frontier = next;
+        }
+
+        A
+    }
+
+    /// Returns the highest and lowest priority in the given set of vertices V.
+    fn get_highest_lowest_prio(&self, V: &Set) -> (Priority, Priority) {
+        let mut highest = usize::MIN;
+        let mut lowest = usize::MAX;
+
+        for v in V.iter_ones() {
+            let prio = self.game.priority(VertexIndex::new(v));
+            highest = highest.max(*prio);
+            lowest = lowest.min(*prio);
+        }
+
+        (Priority::new(highest), Priority::new(lowest))
+    }
+
+    /// Checks that the given solutions are a valid partition of the vertices in V
+    fn check_partition(&self, W0: &Set, W1: &Set, V: &Set) {
+        let intersection = W0.clone() & W1;
+        if intersection.any() {
+            panic!(
+                "The winning sets are not disjoint. Vertices in both sets: {}",
+                intersection
+            );
+        }
+
+        let both = W0.clone() | W1;
+        if both != *V {
+            let missing = V.clone() & !both;
+            panic!(
+                "The winning sets do not cover all vertices. Missing vertices: {}",
+                missing
+            );
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use merc_utilities::random_test;
+
+    use crate::random_parity_game;
+    use crate::solve_zielonka;
+    use crate::solve_zielonka_parallel;
+
+    #[test]
+    #[cfg_attr(miri, ignore)] // Very slow under Miri
+    fn test_random_parity_game_solve_parallel() {
+        random_test(50, |rng| {
+            let pg = random_parity_game(rng, true, 100, 5, 3);
+
+            let expected = solve_zielonka(&pg);
+            let solution = solve_zielonka_parallel(&pg, 4);
+
+            assert_eq!(
+                solution, expected,
+                "The parallel solution should match the sequential solution"
+            );
+        })
+    }
+}
@@ -17,11 +17,14 @@ use merc_lts::apply_lts_pair;
 use merc_lts::guess_lts_format_from_extension;
 use merc_lts::read_explicit_lts;
 use merc_lts::write_aut;
+use merc_lts::write_aut_parallel;
 use merc_lts::write_bcg;
+use merc_lts::write_mlts;
 use merc_preorder::RefinementType;
 use merc_preorder::refines;
 use merc_reduction::Equivalence;
-use merc_reduction::reduce_lts;
+use merc_reduction::reduce_lts_parallel;
+use merc_tools::MetricsFlag;
 use merc_tools::Version;
 use merc_tools::VersionFlag;
 use merc_tools::verbosity::VerbosityFlag;
@@ -41,6 +44,9 @@ struct Cli {
     #[command(flatten)]
     verbosity: VerbosityFlag,
 
+    #[command(flatten)]
+    metrics: MetricsFlag,
+
     #[command(subcommand)]
     commands: Option<Commands>,
 
@@ -85,6 +91,13 @@ struct ReduceArgs {
         value_delimiter = ','
     )]
     tau: Option<Vec<String>>,
+
+    #[arg(
+        long,
+        default_value_t = 1,
+        help = "Number of worker threads for equivalences with a parallel implementation"
+    )]
+    threads: usize,
 }
 
 #[derive(clap::Args, Debug)]
@@ -165,6 +178,7 @@ fn main() -> Result<ExitCode, MercError> {
         return Ok(ExitCode::SUCCESS);
     }
 
+    cli.metrics.enable();
     let mut timing = Timing::new();
 
     if let Some(command) = &cli.commands {
@@ -191,6 +205,8 @@ fn main() -> Result<ExitCode, MercError> {
         timing.print();
     }
 
+    cli.metrics.finish("lts")?;
+
     print_allocator_metrics();
     Ok(ExitCode::SUCCESS)
 }
@@ -230,7 +246,7 @@ fn handle_reduce(args: &ReduceArgs, timing: &mut Timing) -> Result<(), MercError
     );
 
     apply_lts!(lts, timing, |lts, timing| -> Result<(), MercError> {
-        let reduced_lts = reduce_lts(lts, args.equivalence, timing);
+        let reduced_lts = reduce_lts_parallel(lts, args.equivalence, args.threads, timing);
 
         info!(
             "Reduced LTS has {} states and {} transitions.",
@@ -240,9 +256,9 @@ fn handle_reduce(args: &ReduceArgs, timing: &mut Timing) -> Result<(), MercError
 
         if let Some(file) = &args.output {
             let mut writer = File::create(file)?;
-            write_aut(&mut writer, &reduced_lts)?;
+            write_aut_parallel(&mut writer, &reduced_lts, args.threads)?;
         } else {
-            write_aut(&mut stdout(), &reduced_lts)?;
+            write_aut_parallel(&mut stdout(), &reduced_lts, args.threads)?;
         }
 
         Ok(())
@@ -351,7 +367,22 @@ fn handle_convert(args: &ConvertArgs, timing: &mut Timing) -> Result<(), MercErr
                 }
             }
             LtsFormat::Aut => {
-                return Err("Conversion from AUT to AUT is not useful.".into());
+                if format == LtsFormat::Aut {
+                    return Err("Conversion from AUT to AUT is not useful.".into());
+                }
+
+                if let Some(path) = &args.output {
+                    write_aut(&mut File::create(path)?, &lts)?;
+                } else {
+                    write_aut(&mut stdout(), &lts)?;
+                }
+            }
+            LtsFormat::Mlts => {
+                if let Some(path) = &args.output {
+                    write_mlts(&mut File::create(path)?, &lts)?;
+                } else {
+                    write_mlts(&mut stdout(), &lts)?;
+                }
             }
             _ => {
                 return Err(format!("Conversion to {output_format:?}LTS format is not yet implemented.").into());
@@ -372,6 +403,13 @@ fn handle_convert(args: &ConvertArgs, timing: &mut Timing) -> Result<(), MercErr
                     return Err("Output path must be specified when writing BCG files.".into());
                 }
             }
+            LtsFormat::Mlts => {
+                if let Some(path) = &args.output {
+                    write_mlts(&mut File::create(path)?, &lts.relabel(|label| label.to_string()))?;
+                } else {
+                    write_mlts(&mut stdout(), &lts.relabel(|label| label.to_string()))?;
+                }
+            }
             LtsFormat::Lts => {
                 return Err("Conversion from LTS to LTS is not useful.".into());
             }
@@ -384,6 +422,13 @@ fn handle_convert(args: &ConvertArgs, timing: &mut Timing) -> Result<(), MercErr
                     write_aut(&mut stdout(), &lts)?;
                 }
             }
+            LtsFormat::Mlts => {
+                if let Some(path) = &args.output {
+                    write_mlts(&mut File::create(path)?, &lts)?;
+                } else {
+                    write_mlts(&mut stdout(), &lts)?;
+                }
+            }
             _ => {
                 return Err(format!("Conversion to {output_format:?}LTS format is not yet implemented.").into());
             }
@@ -149,6 +149,30 @@ inline const detail::_aterm* mcrl2_aterm_create(const detail::_function_symbol&
   return 0;
 }
 
+inline void mcrl2_aterm_create_batch(rust::Slice<const detail::_function_symbol* const> symbols,
+    rust::Slice<const detail::_aterm* const> leaves,
+    rust::Slice<const std::size_t> arguments,
+    rust::Slice<const detail::_aterm*> results)
+{
+  std::vector<const detail::_aterm*> args;
+  std::size_t offset = 0;
+
+  for (std::size_t i = 0; i < symbols.size(); ++i)
+  {
+    const detail::_function_symbol& symbol = *symbols[i];
+
+    args.clear();
+    for (std::size_t j = 0; j < symbol.arity(); ++j)
+    {
+      std::size_t reference = arguments[offset + j];
+      args.push_back(reference < leaves.size() ? leaves[reference] : results[reference - leaves.size()]);
+    }
+    offset += symbol.arity();
+
+    results[i] = mcrl2_aterm_create(symbol, rust::Slice<const detail::_aterm* const>(args.data(), args.size()));
+  }
+}
+
 inline std::unique_ptr<aterm> mcrl2_aterm_from_string(rust::Str text)
 {
   return std::make_unique<aterm>(read_term_from_string(static_cast<std::string>(text)));
@@ -203,6 +227,16 @@ inline const detail::_aterm* mcrl2_aterm_get_argument(const detail::_aterm& term
   return detail::address(atermpp::down_cast<aterm>(tmp)[index]);
 }
 
+inline void mcrl2_aterm_get_arguments(const detail::_aterm& term, rust::Slice<const detail::_aterm*> results)
+{
+  atermpp::unprotected_aterm_core tmp(&term);
+  const aterm& appl = atermpp::down_cast<aterm>(tmp);
+  for (std::size_t index = 0; index < results.size(); ++index)
+  {
+    results[index] = detail::address(appl[index]);
+  }
+}
+
 // Function symbol related functions
 
 inline const detail::_function_symbol* mcrl2_function_symbol_create(rust::String name, std::size_t arity)
@@ -130,18 +130,42 @@ std::size_t mcrl2_local_control_flow_graph_vertices(const detail::local_control_
   return cfg.vertices.size();
 }
 
-inline
-const detail::local_control_flow_graph_vertex& mcrl2_local_control_flow_graph_vertex(const detail::local_control_flow_graph& cfg, std::size_t index)
+/// A table of pointers to the vertices of a local control flow graph. The
+/// vertices themselves are stored in a std::set, which only allows linear
+/// iterator based lookups, so we build this table once to provide O(1)
+/// indexed access. The pointers remain valid since the set is not modified
+/// after the algorithm has run.
+class local_control_flow_graph_vertex_table
 {
-  for (auto it = cfg.vertices.begin(); it != cfg.vertices.end(); ++it)
+public:
+  local_control_flow_graph_vertex_table(const detail::local_control_flow_graph& cfg)
   {
-    if (std::distance(cfg.vertices.begin(), it) == static_cast<std::ptrdiff_t>(index))
+    m_vertices.reserve(cfg.vertices.size());
+    for (const auto& vertex : cfg.vertices)
     {
-      return *it;
+      m_vertices.push_back(&vertex);
     }
   }
 
-  throw std::out_of_range("Index out of range in mcrl2_local_control_flow_graph_vertex");
+  const detail::local_control_flow_graph_vertex& at(std::size_t index) const
+  {
+    return *m_vertices.at(index);
+  }
+
+private:
+  std::vector<const detail::local_control_flow_graph_vertex*> m_vertices;
+};
+
+inline
+std::unique_ptr<local_control_flow_graph_vertex_table> mcrl2_local_control_flow_graph_vertex_table(const detail::local_control_flow_graph& cfg)
+{
+  return std::make_unique<local_control_flow_graph_vertex_table>(cfg);
+}
+
+inline
+const detail::local_control_flow_graph_vertex& mcrl2_local_control_flow_graph_vertex_table_at(const local_control_flow_graph_vertex_table& table, std::size_t index)
+{
+  return table.at(index);
 }
 
 // namespace mcrl2::pbes_system::detail::local_control_flow_graph_vertex
@@ -216,20 +240,17 @@ void mcrl2_srf_pbes_unify_parameters(srf_pbes& p, bool ignore_ce_equations, bool
 // mcrl2::pbes_system::detail::predicate_variable
 
 inline
-std::unique_ptr<std::vector<detail::predicate_variable>> mcrl2_stategraph_equation_predicate_variables(const detail::stategraph_equation& eqn)
+const std::vector<detail::predicate_variable>& mcrl2_stategraph_equation_predicate_variables(const detail::stategraph_equation& eqn)
 {
-  std::vector<detail::predicate_variable> result;
-  for (const auto& v : eqn.predicate_variables())
-  {
-    result.push_back(v);
-  }
-  return std::make_unique<std::vector<detail::predicate_variable>>(std::move(result));
+  return eqn.predicate_variables();
 }
 
 inline
 rust::Vec<std::size_t> mcrl2_predicate_variable_used(const detail::predicate_variable& v)
 {
+  // The used set is a std::set, which is node based, so a copy cannot be avoided.
   rust::Vec<std::size_t> result;
+  result.reserve(v.used().size());
   for (const auto& index : v.used())
   {
     result.push_back(index);
@@ -241,6 +262,7 @@ inline
 rust::Vec<std::size_t> mcrl2_predicate_variable_changed(const detail::predicate_variable& v)
 {
   rust::Vec<std::size_t> result;
+  result.reserve(v.changed().size());
   for (const auto& index : v.changed())
   {
     result.push_back(index);
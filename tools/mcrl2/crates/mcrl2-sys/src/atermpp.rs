@@ -71,6 +71,27 @@ pub mod ffi {
         /// garbage collection marks the terms, which is done atomically.
         unsafe fn mcrl2_aterm_create(function: &_function_symbol, arguments: &[*const _aterm]) -> *const _aterm;
 
+        /// Creates the terms described by a flat post-order batch in a single
+        /// call, amortizing the boundary crossing over the whole batch.
+        ///
+        /// Every entry of `symbols` describes one term; its arguments are the
+        /// next arity many entries of `arguments`. An argument value below
+        /// `leaves.len()` refers to the leaf term with that index, any other
+        /// value v refers to batch term `v - leaves.len()`, which must occur
+        /// earlier in the batch. The addresses of all created terms are
+        /// written to `results`, which must have the same length as `symbols`.
+        ///
+        /// # Safety
+        /// The caller must keep the pool locked for shared access during the
+        /// call so the intermediate terms cannot be garbage collected, and
+        /// protect the results before the busy flags are set to false.
+        unsafe fn mcrl2_aterm_create_batch(
+            symbols: &[*const _function_symbol],
+            leaves: &[*const _aterm],
+            arguments: &[usize],
+            results: &mut [*const _aterm],
+        );
+
         /// Parses the given string and returns an aterm
         fn mcrl2_aterm_from_string(text: &str) -> Result<UniquePtr<aterm>>;
 
@@ -95,6 +116,11 @@ pub mod ffi {
         /// Returns the ith argument of this term.
         fn mcrl2_aterm_get_argument(term: &_aterm, index: usize) -> *const _aterm;
 
+        /// Writes the addresses of all arguments of this term into the output
+        /// slice, which must have the arity of the term as its length. Avoids
+        /// one call per argument when traversing terms.
+        fn mcrl2_aterm_get_arguments(term: &_aterm, results: &mut [*const _aterm]);
+
         /// Returns the function symbol of an aterm.
         fn mcrl2_aterm_get_function_symbol(term: &_aterm) -> *const _function_symbol;
 
@@ -64,10 +64,11 @@ pub mod ffi {
         #[namespace = "mcrl2::pbes_system::detail"]
         type predicate_variable;
 
-        /// Returns the predicate variables of a stategraph equation.
+        /// Returns the predicate variables of a stategraph equation, as a
+        /// reference to the vector owned by the equation itself.
         fn mcrl2_stategraph_equation_predicate_variables(
             input: &stategraph_equation,
-        ) -> UniquePtr<CxxVector<predicate_variable>>;
+        ) -> &CxxVector<predicate_variable>;
 
         /// Returns the propositional variable of a pbes equation
         fn mcrl2_stategraph_equation_variable(equation: &stategraph_equation) -> *const _aterm;
@@ -84,8 +85,17 @@ pub mod ffi {
         /// Obtain the vertices of a cfg.
         fn mcrl2_local_control_flow_graph_vertices(input: &local_control_flow_graph) -> usize;
 
-        fn mcrl2_local_control_flow_graph_vertex(
+        type local_control_flow_graph_vertex_table;
+
+        /// Builds a pointer table over the vertices of the cfg, which are
+        /// stored in a std::set, to allow O(1) indexed access.
+        fn mcrl2_local_control_flow_graph_vertex_table(
             input: &local_control_flow_graph,
+        ) -> UniquePtr<local_control_flow_graph_vertex_table>;
+
+        /// Returns the vertex at the given index in the table.
+        fn mcrl2_local_control_flow_graph_vertex_table_at(
+            table: &local_control_flow_graph_vertex_table,
             index: usize,
         ) -> &local_control_flow_graph_vertex;
 
@@ -12,6 +12,7 @@ use mcrl2_sys::atermpp::ffi::_aterm;
 use mcrl2_sys::atermpp::ffi::aterm;
 use mcrl2_sys::atermpp::ffi::mcrl2_aterm_get_address;
 use mcrl2_sys::atermpp::ffi::mcrl2_aterm_get_argument;
+use mcrl2_sys::atermpp::ffi::mcrl2_aterm_get_arguments;
 use mcrl2_sys::atermpp::ffi::mcrl2_aterm_get_function_symbol;
 use mcrl2_sys::atermpp::ffi::mcrl2_aterm_is_empty_list;
 use mcrl2_sys::atermpp::ffi::mcrl2_aterm_is_int;
@@ -142,6 +143,22 @@ impl ATermRef<'_> {
         ATermArgs::new(self.copy())
     }
 
+    /// Writes all arguments of the term into the given buffer using a single
+    /// FFI call, instead of one call per argument as with [ATermRef::arg].
+    pub fn arguments_into<'b>(&'b self, result: &mut Vec<ATermRef<'b>>) {
+        self.require_valid();
+
+        let arity = self.get_head_symbol().arity();
+        result.clear();
+        if arity == 0 {
+            return;
+        }
+
+        let mut addresses: Vec<*const ffi::_aterm> = vec![std::ptr::null(); arity];
+        mcrl2_aterm_get_arguments(self.get(), &mut addresses);
+        result.extend(addresses.into_iter().map(ATermRef::new));
+    }
+
     /// Makes a copy of the term with the same lifetime as itself.
     pub fn copy(&self) -> ATermRef<'_> {
         ATermRef::new(self.term)
@@ -420,6 +437,20 @@ impl<'a> Iterator for TermIterator<'a> {
 mod tests {
     use crate::ATerm;
 
+    #[test]
+    fn test_arguments_into() {
+        let t = ATerm::from_string("f(g(a),b)").unwrap();
+        let a = ATerm::from_string("a").unwrap();
+
+        let mut arguments = Vec::new();
+        t.arguments_into(&mut arguments);
+        assert_eq!(arguments, t.arguments().collect::<Vec<_>>());
+
+        // A constant has no arguments and must clear the buffer.
+        a.arguments_into(&mut arguments);
+        assert!(arguments.is_empty());
+    }
+
     #[test]
     fn test_term_iterator() {
         let t = ATerm::from_string("f(g(a),b)").unwrap();
@@ -163,6 +163,52 @@ impl ThreadTermPool {
         }
     }
 
+    /// Creates the terms described by a flat post-order batch in a single FFI
+    /// call, see [ffi::mcrl2_aterm_create_batch] for the batch encoding.
+    ///
+    /// The pool lock is kept for the whole batch and only the term of the last
+    /// entry is protected and returned; the intermediate terms are kept alive
+    /// through the result.
+    pub fn create_batch<'a, 'b>(
+        &self,
+        symbols: &[impl Borrow<SymbolRef<'a>>],
+        leaves: &[impl Borrow<ATermRef<'b>>],
+        arguments: &[usize],
+    ) -> ATerm {
+        debug_assert!(!symbols.is_empty(), "The batch must contain at least one term");
+        debug_assert_eq!(
+            symbols.iter().map(|symbol| symbol.borrow().arity()).sum::<usize>(),
+            arguments.len(),
+            "Number of arguments does not match the arities of the batch"
+        );
+        debug_assert!(
+            arguments
+                .iter()
+                .all(|&reference| reference < leaves.len() + symbols.len()),
+            "Argument reference is out of bounds"
+        );
+
+        // Copy the leaves to make a slice.
+        let mut tmp_args = self.arguments.borrow_mut();
+        tmp_args.clear();
+        for leaf in leaves {
+            tmp_args.push(leaf.borrow().get());
+        }
+
+        let tmp_symbols: Vec<*const ffi::_function_symbol> = symbols
+            .iter()
+            .map(|symbol| symbol.borrow().get() as *const ffi::_function_symbol)
+            .collect();
+        let mut results: Vec<*const ffi::_aterm> = vec![std::ptr::null(); tmp_symbols.len()];
+
+        unsafe {
+            // ThreadPool is not Sync, so only one has access.
+            let protection_set = self.protection_set.write_exclusive();
+            ffi::mcrl2_aterm_create_batch(&tmp_symbols, &tmp_args, arguments, &mut results);
+            self.protect_with(protection_set, *results.last().expect("The batch is not empty"))
+        }
+    }
+
     /// Creates a function symbol with the given name and arity.
     pub fn create_symbol(&self, name: &str, arity: usize) -> Symbol {
         Symbol::take(mcrl2_function_symbol_create(String::from(name), arity))
@@ -349,4 +395,56 @@ mod tests {
             }
         });
     }
+
+    #[test]
+    fn test_create_batch() {
+        let seed: u64 = rand::rng().random();
+        println!("seed: {}", seed);
+        let mut rng = StdRng::seed_from_u64(seed);
+
+        THREAD_TERM_POOL.with_borrow(|tp| {
+            let f = tp.create_symbol("f", 2);
+            let leaves = [
+                tp.create(&tp.create_symbol("a", 0), &[] as &[ATerm]),
+                tp.create(&tp.create_symbol("b", 0), &[] as &[ATerm]),
+            ];
+
+            // Build a random post-order batch of f(x, y) terms whose arguments
+            // refer to the leaves or to earlier entries of the batch, and the
+            // same terms one by one through create.
+            let length = rng.random_range(1..20);
+            let mut symbols = Vec::new();
+            let mut arguments = Vec::new();
+            let mut expected: Vec<ATerm> = Vec::new();
+            for index in 0..length {
+                let mut subterms = Vec::new();
+                for _ in 0..f.arity() {
+                    let reference = rng.random_range(0..leaves.len() + index);
+                    arguments.push(reference);
+                    if reference < leaves.len() {
+                        subterms.push(leaves[reference].clone());
+                    } else {
+                        subterms.push(expected[reference - leaves.len()].clone());
+                    }
+                }
+
+                symbols.push(f.clone());
+                expected.push(tp.create(&f, &subterms));
+            }
+
+            let term = tp.create_batch(&symbols, &leaves, &arguments);
+            assert_eq!(
+                term,
+                *expected.last().unwrap(),
+                "The batch must build the same term as create"
+            );
+
+            // Only the final term of the batch is protected; after dropping
+            // every other reference a collection must keep its subterms alive
+            // through it.
+            drop(expected);
+            tp.collect();
+            verify_term(&term);
+        });
+    }
 }
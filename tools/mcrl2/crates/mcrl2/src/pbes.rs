@@ -8,10 +8,11 @@ use mcrl2_sys::pbes::ffi::local_control_flow_graph_vertex;
 use mcrl2_sys::pbes::ffi::mcrl2_load_pbes_from_pbes_file;
 use mcrl2_sys::pbes::ffi::mcrl2_load_pbes_from_text;
 use mcrl2_sys::pbes::ffi::mcrl2_load_pbes_from_text_file;
-use mcrl2_sys::pbes::ffi::mcrl2_local_control_flow_graph_vertex;
 use mcrl2_sys::pbes::ffi::mcrl2_local_control_flow_graph_vertex_index;
 use mcrl2_sys::pbes::ffi::mcrl2_local_control_flow_graph_vertex_name;
 use mcrl2_sys::pbes::ffi::mcrl2_local_control_flow_graph_vertex_outgoing_edges;
+use mcrl2_sys::pbes::ffi::mcrl2_local_control_flow_graph_vertex_table;
+use mcrl2_sys::pbes::ffi::mcrl2_local_control_flow_graph_vertex_table_at;
 use mcrl2_sys::pbes::ffi::mcrl2_local_control_flow_graph_vertex_value;
 use mcrl2_sys::pbes::ffi::mcrl2_local_control_flow_graph_vertices;
 use mcrl2_sys::pbes::ffi::mcrl2_pbes_data_specification;
@@ -156,8 +157,14 @@ impl ControlFlowGraph {
 
     pub(crate) fn new(algorithm: Rc<UniquePtr<stategraph_algorithm>>, index: usize) -> Self {
         let cfg = mcrl2_stategraph_local_algorithm_cfg(&algorithm, index);
+
+        // Build a pointer table once since the vertices are stored in a set,
+        // which does not allow indexed access.
+        let table = mcrl2_local_control_flow_graph_vertex_table(cfg);
         let vertices = (0..mcrl2_local_control_flow_graph_vertices(cfg))
-            .map(|vertex_index| ControlFlowGraphVertex::new(algorithm.clone(), index, vertex_index))
+            .map(|vertex_index| {
+                ControlFlowGraphVertex::new(mcrl2_local_control_flow_graph_vertex_table_at(&table, vertex_index))
+            })
             .collect::<Vec<_>>();
 
         ControlFlowGraph { vertices }
@@ -200,10 +207,7 @@ impl ControlFlowGraphVertex {
     }
 
     /// Construct a new vertex and retrieve its edges as well.
-    /// TODO: This should probably be private.
-    pub fn new(algorithm: Rc<UniquePtr<stategraph_algorithm>>, cfg: usize, vertex: usize) -> Self {
-        let cfg = mcrl2_stategraph_local_algorithm_cfg(&algorithm, cfg);
-        let vertex = mcrl2_local_control_flow_graph_vertex(cfg, vertex);
+    pub(crate) fn new(vertex: &local_control_flow_graph_vertex) -> Self {
         let outgoing_edges_ffi = mcrl2_local_control_flow_graph_vertex_outgoing_edges(vertex);
 
         let outgoing_edges = outgoing_edges_ffi
@@ -284,8 +288,13 @@ impl StategraphEquation {
 
     pub(crate) fn new(algorithm: Rc<UniquePtr<stategraph_algorithm>>, index: usize) -> Self {
         let equation = mcrl2_stategraph_local_algorithm_equation(&algorithm, index);
-        let predicate_variables = mcrl2_stategraph_equation_predicate_variables(equation);
-        let predicate_variables = predicate_variables.iter().map(|v| PredicateVariable::new(v)).collect();
+
+        // The returned vector is owned by the equation itself, so this does
+        // not copy the predicate variables.
+        let predicate_variables = mcrl2_stategraph_equation_predicate_variables(equation)
+            .iter()
+            .map(|v| PredicateVariable::new(v))
+            .collect();
 
         StategraphEquation {
             predicate_variables,
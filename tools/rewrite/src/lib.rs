@@ -5,6 +5,7 @@ use clap::ValueEnum;
 
 use merc_data::to_untyped_data_expression;
 use merc_rec_tests::load_rec_from_file;
+use merc_sabre::CompiledRewriter;
 use merc_sabre::InnermostRewriter;
 use merc_sabre::NaiveRewriter;
 use merc_sabre::RewriteEngine;
@@ -16,6 +17,7 @@ use merc_utilities::MercError;
 pub enum Rewriter {
     Naive,
     Innermost,
+    Compiled,
     Sabre,
 }
 
@@ -52,6 +54,19 @@ pub fn rewrite_rec(rewriter: Rewriter, filename_specification: &str, output: boo
             }
             println!("Innermost rewrite took {} ms", now.elapsed().as_millis());
         }
+        Rewriter::Compiled => {
+            let mut compiled = CompiledRewriter::new(&spec);
+
+            let now = Instant::now();
+            for term in &syntax_terms {
+                let term = to_untyped_data_expression(term.clone(), None);
+                let result = compiled.rewrite(&term);
+                if output {
+                    println!("{}", result)
+                }
+            }
+            println!("Compiled rewrite took {} ms", now.elapsed().as_millis());
+        }
         Rewriter::Sabre => {
             let mut sa = SabreRewriter::new(&spec);
 
@@ -6,6 +6,7 @@ use clap::Parser;
 use clap::Subcommand;
 
 use merc_rec_tests::load_rec_from_file;
+use merc_tools::MetricsFlag;
 use merc_tools::VerbosityFlag;
 use merc_tools::Version;
 use merc_tools::VersionFlag;
@@ -28,6 +29,9 @@ struct Cli {
     #[command(flatten)]
     verbosity: VerbosityFlag,
 
+    #[command(flatten)]
+    metrics: MetricsFlag,
+
     #[command(subcommand)]
     commands: Option<Commands>,
 }
@@ -75,6 +79,8 @@ fn main() -> Result<ExitCode, MercError> {
         return Ok(ExitCode::SUCCESS);
     }
 
+    cli.metrics.enable();
+
     if let Some(command) = cli.commands {
         match command {
             Commands::Rewrite(args) => {
@@ -96,6 +102,7 @@ fn main() -> Result<ExitCode, MercError> {
         }
     }
 
+    cli.metrics.finish("rewrite")?;
     print_allocator_metrics();
     Ok(ExitCode::SUCCESS)
 }
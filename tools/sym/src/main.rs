@@ -7,12 +7,14 @@ use clap::Subcommand;
 
 use merc_io::LargeFormatter;
 use merc_ldd::Storage;
+use merc_symbolic::ReachabilityStrategy;
 use merc_symbolic::SymFormat;
 use merc_symbolic::SymbolicLTS;
 use merc_symbolic::guess_format_from_extension;
-use merc_symbolic::reachability;
-use merc_symbolic::read_sylvan;
+use merc_symbolic::reachability_with_strategy;
+use merc_symbolic::read_sylvan_file;
 use merc_symbolic::read_symbolic_lts;
+use merc_tools::MetricsFlag;
 use merc_tools::Version;
 use merc_tools::VersionFlag;
 use merc_tools::verbosity::VerbosityFlag;
@@ -32,6 +34,9 @@ struct Cli {
     #[command(flatten)]
     verbosity: VerbosityFlag,
 
+    #[command(flatten)]
+    metrics: MetricsFlag,
+
     #[command(subcommand)]
     commands: Option<Commands>,
 
@@ -58,6 +63,10 @@ struct ExploreArgs {
     filename: PathBuf,
 
     format: Option<SymFormat>,
+
+    /// The exploration strategy used during reachability.
+    #[arg(long, value_enum, default_value = "bfs")]
+    strategy: ReachabilityStrategy,
 }
 
 fn main() -> Result<ExitCode, MercError> {
@@ -73,6 +82,7 @@ fn main() -> Result<ExitCode, MercError> {
         return Ok(ExitCode::SUCCESS);
     }
 
+    cli.metrics.enable();
     let mut timing = Timing::new();
 
     if let Some(command) = cli.commands {
@@ -86,6 +96,8 @@ fn main() -> Result<ExitCode, MercError> {
         timing.print();
     }
 
+    cli.metrics.finish("sym")?;
+
     print_allocator_metrics();
     Ok(ExitCode::SUCCESS)
 }
@@ -120,11 +132,14 @@ fn handle_explore(args: ExploreArgs, _timing: &mut Timing) -> Result<(), MercErr
     match format {
         SymFormat::Sylvan => {
             let mut time_read = timing.start("read_lts");
-            let lts = read_sylvan(&mut storage, &mut file)?;
+            let lts = read_sylvan_file(&mut storage, &args.filename)?;
             time_read.finish();
 
             let mut time_explore = timing.start("explore");
-            println!("LTS has {} states", reachability(&mut storage, &lts)?);
+            println!(
+                "LTS has {} states",
+                reachability_with_strategy(&mut storage, &lts, args.strategy)?
+            );
             time_explore.finish();
         }
         SymFormat::Sym => {
@@ -17,6 +17,7 @@ use oxidd::BooleanFunction;
 use merc_symbolic::CubeIterAll;
 use merc_symbolic::FormatConfig;
 use merc_syntax::UntypedStateFrmSpec;
+use merc_tools::MetricsFlag;
 use merc_tools::VerbosityFlag;
 use merc_tools::Version;
 use merc_tools::VersionFlag;
@@ -37,7 +38,7 @@ use merc_vpg::read_pg;
 use merc_vpg::read_vpg;
 use merc_vpg::solve_variability_product_zielonka;
 use merc_vpg::solve_variability_zielonka;
-use merc_vpg::solve_zielonka;
+use merc_vpg::solve_zielonka_parallel;
 use merc_vpg::translate;
 use merc_vpg::write_pg;
 use merc_vpg::write_vpg;
@@ -57,6 +58,9 @@ struct Cli {
     #[command(flatten)]
     verbosity: VerbosityFlag,
 
+    #[command(flatten)]
+    metrics: MetricsFlag,
+
     #[arg(long, global = true)]
     timings: bool,
 
@@ -102,6 +106,11 @@ struct SolveArgs {
     /// Whether to verify the solution after computing it
     #[arg(long, default_value_t = false)]
     verify_solution: bool,
+
+    /// Number of worker threads for the parallel attractor computation, only
+    /// used for standard parity games.
+    #[arg(long, default_value_t = 1)]
+    threads: usize,
 }
 
 /// Arguments for computing the reachable part of a parity game
@@ -162,6 +171,7 @@ struct DisplayArgs {
 fn main() -> Result<ExitCode, MercError> {
     let cli = Cli::parse();
 
+    cli.metrics.enable();
     let mut timing = Timing::new();
 
     env_logger::Builder::new()
@@ -188,6 +198,7 @@ fn main() -> Result<ExitCode, MercError> {
         timing.print();
     }
 
+    cli.metrics.finish("vpg")?;
     print_allocator_metrics();
     if cfg!(feature = "merc_metrics") {
         oxidd::bdd::print_stats();
@@ -212,7 +223,7 @@ fn handle_solve(cli: &Cli, args: &SolveArgs, timing: &mut Timing) -> Result<(),
         time_read.finish();
 
         let mut time_solve = timing.start("solve_zielonka");
-        let solution = solve_zielonka(&game);
+        let solution = solve_zielonka_parallel(&game, args.threads);
         if args.full_solution {
             for (index, player_set) in solution.iter().enumerate() {
                 println!("W{index}: {}", player_set.iter_ones().format(", "));